@@ -0,0 +1,29 @@
+#!/bin/bash
+# Number of states stored by the exhaustive exploration
+# with and without --compact, on the sample programs
+# and on larger generated ones
+#
+#   bench/compact.sh [EXTRA FLAGS...]
+
+cd "$(dirname "$0")/.."
+BIN=./lang
+TMP=$(mktemp -d)
+trap 'rm -rf $TMP' EXIT
+
+bench/gen.sh counters 4 6 > $TMP/counters-4-6.prog
+bench/gen.sh filter 4 > $TMP/filter-4.prog
+
+MODELS=$(ls assets/*.prog)
+MODELS="$MODELS $TMP/*.prog"
+
+states () {
+    $BIN "$@" --all --full --no-color --stats | awk '/Stats:/ { print $2 }'
+}
+
+printf "%-20s%12s%12s%10s\n" "model" "states" "compact" "delta"
+for model in $MODELS; do
+    before=$(states $model "$@")
+    after=$(states $model --compact "$@")
+    printf "%-20s%12s%12s" "$(basename $model .prog)" $before $after
+    awk "BEGIN { printf \"%9.1f%%\n\", $before ? 100 * ($after - $before) / $before : 0 }"
+done
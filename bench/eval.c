@@ -0,0 +1,135 @@
+// Compare the recursive evaluator with the bytecode on typical guards
+//
+//   make bench-eval
+//
+// Both evaluators are run on the same random states and must agree.
+
+#include "../src/exec.h"
+#include "../src/bytecode.h"
+#include "../src/prelude.h"
+#include "../src/rng.h"
+#include <time.h>
+
+#define NBVAR 4
+#define NBSTATE 1024
+#define ROUNDS 2000
+
+Var vars [NBVAR];
+Field fields [NBVAR];
+Interval bounds [NBVAR];
+
+RExpr* leaf_var (uint id) {
+    RExpr* e = malloc(sizeof(RExpr));
+    e->type = E_VAR;
+    e->val.var = vars + id;
+    return e;
+}
+
+RExpr* leaf_val (uint digit) {
+    RExpr* e = malloc(sizeof(RExpr));
+    e->type = E_VAL;
+    e->val.digit = digit;
+    return e;
+}
+
+RExpr* bin (RExprKind type, RExpr* lhs, RExpr* rhs) {
+    RExpr* e = malloc(sizeof(RExpr));
+    e->type = type;
+    e->val.binop = malloc(sizeof(RBinop));
+    e->val.binop->lhs = lhs;
+    e->val.binop->rhs = rhs;
+    return e;
+}
+
+RExpr* mon (RExprKind type, RExpr* sub) {
+    RExpr* e = malloc(sizeof(RExpr));
+    e->type = type;
+    e->val.subexpr = sub;
+    return e;
+}
+
+double now () {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+int main () {
+    // a b c d, 8 bits each
+    Layout layout = { 1, 8 * NBVAR, fields, NULL, bounds };
+    for (uint i = 0; i < NBVAR; i++) {
+        vars[i].id = i;
+        fields[i].word = 0;
+        fields[i].shift = 8 * i;
+        fields[i].mask = 0xff;
+        fields[i].base = -128;
+        bounds[i].lo = -128;
+        bounds[i].hi = 127;
+    }
+    RProg prog;
+    prog.nbvar = NBVAR;
+    prog.layout = &layout;
+    RExpr* exprs [] = {
+        // a == 0
+        bin(E_EQ, leaf_var(0), leaf_val(0)),
+        // a + 1 < b && !(c == d)
+        bin(E_AND,
+            bin(E_LT, bin(E_ADD, leaf_var(0), leaf_val(1)), leaf_var(1)),
+            mon(E_NOT, bin(E_EQ, leaf_var(2), leaf_var(3)))),
+        // (a * b - c) % (d + 3) >= -2 || a / b > 1
+        bin(E_OR,
+            bin(E_GEQ,
+                bin(E_MOD,
+                    bin(E_SUB, bin(E_MUL, leaf_var(0), leaf_var(1)), leaf_var(2)),
+                    bin(E_ADD, leaf_var(3), leaf_val(3))),
+                mon(E_NEG, leaf_val(2))),
+            bin(E_GT, bin(E_DIV, leaf_var(0), leaf_var(1)), leaf_val(1))),
+        // a + (b - 1 .. b + 1)
+        bin(E_ADD, leaf_var(0),
+            bin(E_RANGE,
+                bin(E_SUB, leaf_var(1), leaf_val(1)),
+                bin(E_ADD, leaf_var(1), leaf_val(1)))),
+    };
+    uint nbexpr = sizeof(exprs) / sizeof(RExpr*);
+    ull states [NBSTATE];
+    srand(42);
+    for (uint s = 0; s < NBSTATE; s++) {
+        states[s] = 0;
+        for (uint i = 0; i < NBVAR; i++) {
+            set_var(&prog, states + s, i, rand() % 21 - 10);
+        }
+    }
+    printf("%-6s%8s%14s%14s%10s\n", "expr", "instrs", "tree (ns)", "code (ns)", "speedup");
+    for (uint e = 0; e < nbexpr; e++) {
+        Code* code = compile_expr(exprs[e], &layout);
+        // sanity check
+        for (uint s = 0; s < NBSTATE; s++) {
+            rng_seed(&thread_rng, s);
+            int expected = eval_expr(exprs[e], &prog, states + s);
+            rng_seed(&thread_rng, s);
+            int actual = exec_code(code, states + s);
+            if (expected != actual) {
+                printf("Mismatch on expr %d: %d vs %d\n", e, expected, actual);
+                return 1;
+            }
+        }
+        volatile int sink = 0;
+        double start = now();
+        for (uint r = 0; r < ROUNDS; r++) {
+            for (uint s = 0; s < NBSTATE; s++) {
+                sink += eval_expr(exprs[e], &prog, states + s);
+            }
+        }
+        double tree = (now() - start) * 1e9 / ROUNDS / NBSTATE;
+        start = now();
+        for (uint r = 0; r < ROUNDS; r++) {
+            for (uint s = 0; s < NBSTATE; s++) {
+                sink += exec_code(code, states + s);
+            }
+        }
+        double flat = (now() - start) * 1e9 / ROUNDS / NBSTATE;
+        printf("%-6d%8d%14.2f%14.2f%9.2fx\n", e, code->nbinstr, tree, flat, tree / flat);
+    }
+    free_repr();
+    return 0;
+}
@@ -0,0 +1,163 @@
+#!/bin/bash
+# Generate scalable models in the .prog syntax
+#
+#   bench/gen.sh counters N M   N processes that each count to M locally
+#                               and then increment a shared counter
+#   bench/gen.sh filter N       filter lock (N-process Peterson),
+#                               mutual exclusion must hold
+#   bench/gen.sh philosophers N dining philosophers, each fork is taken
+#                               without a lock
+#   bench/gen.sh buffer N K     N producers and N consumers of a buffer
+#                               of K items, the test and the update of
+#                               the count are not atomic
+#   bench/gen.sh grid N M       N independent processes that each count
+#                               to M in a global counter, the states
+#                               grow as M^N
+
+usage () {
+    echo "Usage: $0 counters N M | filter N | philosophers N | buffer N K | grid N M" >&2
+    exit 1
+}
+
+counters () {
+    local n=$1 m=$2
+    echo "var done;"
+    for i in $(seq 1 $n); do
+        cat <<PROC
+
+proc p$i
+    var i, x;
+    do
+    :: i < $m -> i := i + 1; x := x + i % 3
+    :: else -> break
+    od;
+    done := done + 1
+end
+PROC
+    done
+    echo
+    echo "reach done == $n // reachable"
+    echo "reach done == $((n + 1)) // unreachable"
+}
+
+filter () {
+    local n=$1
+    local decl="var cs"
+    for i in $(seq 1 $n); do decl="$decl, lv$i"; done
+    for l in $(seq 1 $((n - 1))); do decl="$decl, vc$l"; done
+    echo "$decl;"
+    for i in $(seq 1 $n); do
+        echo
+        echo "proc p$i"
+        echo "    do"
+        echo "    :: 1 ->"
+        for l in $(seq 1 $((n - 1))); do
+            local others=""
+            for k in $(seq 1 $n); do
+                [ $k -eq $i ] && continue
+                others="$others${others:+ && }lv$k < $l"
+            done
+            echo "        lv$i := $l; vc$l := $i;"
+            echo "        do :: ($others) || !(vc$l == $i) -> break od;"
+        done
+        echo "        cs := cs + 1;"
+        echo "        cs := cs - 1;"
+        echo "        lv$i := 0"
+        echo "    od"
+        echo "end"
+    done
+    echo
+    echo "reach cs == 1 // reachable"
+    echo "reach cs == 2 // unreachable"
+}
+
+philosophers () {
+    local n=$1
+    local decl="var eating"
+    for i in $(seq 1 $n); do decl="$decl, f$i"; done
+    echo "$decl;"
+    for i in $(seq 1 $n); do
+        local left=f$i right=f$((i % n + 1))
+        cat <<PROC
+
+proc p$i
+    do
+    :: 1 ->
+        do :: $left == 0 -> break od;
+        $left := $i;
+        do :: $right == 0 -> break od;
+        $right := $i;
+        eating := eating + 1;
+        eating := eating - 1;
+        $right := 0;
+        $left := 0
+    od
+end
+PROC
+    done
+    local all=""
+    for i in $(seq 1 $n); do all="$all${all:+ && }f$i == $i"; done
+    echo
+    echo "reach eating == 1 // reachable"
+    echo "reach $all // reachable, deadlock"
+    echo "reach eating == $n // reachable, taking a fork is not atomic"
+}
+
+buffer () {
+    local n=$1 k=$2
+    echo "var count;"
+    for i in $(seq 1 $n); do
+        cat <<PROC
+
+proc prod$i
+    var made;
+    do
+    :: count < $k -> count := count + 1; made := (made + 1) % $k
+    od
+end
+
+proc cons$i
+    var used;
+    do
+    :: count > 0 -> count := count - 1; used := (used + 1) % $k
+    od
+end
+PROC
+    done
+    echo
+    echo "reach count == $k // reachable"
+    echo "reach count > $k // reachable iff N > 1"
+    echo "reach count < 0 // reachable iff N > 1"
+}
+
+grid () {
+    local n=$1 m=$2
+    local decl="var c1"
+    for i in $(seq 2 $n); do decl="$decl, c$i"; done
+    echo "$decl;"
+    for i in $(seq 1 $n); do
+        cat <<PROC
+
+proc p$i
+    do
+    :: c$i < $m -> c$i := c$i + 1
+    :: else -> break
+    od
+end
+PROC
+    done
+    local all=""
+    for i in $(seq 1 $n); do all="$all${all:+ && }c$i == $m"; done
+    echo
+    echo "reach $all // reachable"
+    echo "reach c1 > $m // unreachable"
+}
+
+case "$1" in
+    counters) [ $# -eq 3 ] || usage; counters $2 $3 ;;
+    filter) [ $# -eq 2 ] || usage; filter $2 ;;
+    philosophers) [ $# -eq 2 ] || usage; philosophers $2 ;;
+    buffer) [ $# -eq 3 ] || usage; buffer $2 $3 ;;
+    grid) [ $# -eq 3 ] || usage; grid $2 $3 ;;
+    *) usage ;;
+esac
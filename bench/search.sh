@@ -0,0 +1,35 @@
+#!/bin/bash
+# Time until the first check is satisfied by the exhaustive exploration
+# in each search order, on the sample programs and on larger generated ones
+#
+#   bench/search.sh [SEARCH MODES...]
+
+cd "$(dirname "$0")/.."
+BIN=./lang
+MODES=${@:-bfs dfs iddfs best}
+TMP=$(mktemp -d)
+trap 'rm -rf $TMP' EXIT
+
+bench/gen.sh counters 4 6 > $TMP/counters-4-6.prog
+bench/gen.sh filter 4 > $TMP/filter-4.prog
+
+MODELS=$(ls assets/*.prog)
+MODELS="$MODELS $TMP/*.prog"
+
+# seconds until the first check is satisfied, - if none is
+first () {
+    $BIN "$@" --all --no-color --stats \
+        | awk '/Found/ { t = $NF + 0; if (!n++ || t < best) best = t }
+            END { if (n) printf "%.3fs\n", best; else print "-" }'
+}
+
+printf "%-20s" "model"
+for mode in $MODES; do printf "%10s" $mode; done
+echo
+for model in $MODELS; do
+    printf "%-20s" "$(basename $model .prog)"
+    for mode in $MODES; do
+        printf "%10s" $(first $model --search $mode)
+    done
+    echo
+done
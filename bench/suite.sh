@@ -0,0 +1,49 @@
+#!/bin/bash
+# Reference workloads: exhaustive and random execution of generated
+# models of increasing size, as CSV on the standard output
+#
+#   bench/suite.sh [EXTRA FLAGS FOR --all...]
+#
+# Columns: model, mode (all or rand), wall time in seconds, peak memory
+# in KB, states stored (--all) or steps executed (--rand) and how many
+# of them per second. Run it before and after a change to compare.
+
+cd "$(dirname "$0")/.."
+BIN=./lang
+MEASURE=build/bench-measure
+TMP=$(mktemp -d)
+trap 'rm -rf $TMP' EXIT
+
+MODELS="
+counters 4 6
+counters 3 10
+filter 3
+filter 4
+philosophers 3
+philosophers 4
+buffer 2 2
+buffer 2 3
+grid 3 8
+grid 4 6
+"
+
+# run `$BIN MODEL FLAGS...` and print the measured columns,
+# the count is the first number after `Stats:` or `walks,`
+measure () {
+    local pattern=$1
+    shift
+    $MEASURE $TMP/measure $BIN "$@" --no-color --stats > $TMP/out
+    local count=$(awk "/$pattern/ { for (i = 1; i < NF; i++) if (\$i == \"$pattern\") { print \$(i + 1) + 0; exit } }" $TMP/out)
+    read secs rss < $TMP/measure
+    awk -v s=$secs -v r=$rss -v c=${count:-0} \
+        'BEGIN { printf "%.3f,%d,%d,%.0f\n", s, r, c, (s > 0 ? c / s : 0) }'
+}
+
+echo "model,mode,seconds,peak_rss_kb,count,per_second"
+echo "$MODELS" | while read family args; do
+    [ -n "$family" ] || continue
+    name="$family-${args// /-}"
+    bench/gen.sh $family $args > $TMP/$name.prog
+    echo "$name,all,$(measure Stats: $TMP/$name.prog --all --full "$@")"
+    echo "$name,rand,$(measure walks, $TMP/$name.prog --rand --seed 1 --walks 2000 --depth 200)"
+done
@@ -0,0 +1,33 @@
+#!/bin/bash
+# Compare exhaustive exploration times for several thread counts
+# on the sample programs and on larger generated ones
+#
+#   bench/threads.sh [THREAD COUNTS...]
+
+cd "$(dirname "$0")/.."
+BIN=./lang
+COUNTS=${@:-1 2 4 8 16 32}
+TMP=$(mktemp -d)
+trap 'rm -rf $TMP' EXIT
+
+bench/gen.sh counters 4 6 > $TMP/counters-4-6.prog
+bench/gen.sh counters 5 5 > $TMP/counters-5-5.prog
+bench/gen.sh filter 4 > $TMP/filter-4.prog
+bench/gen.sh filter 5 > $TMP/filter-5.prog
+
+MODELS=$(ls assets/*.prog)
+MODELS="$MODELS $TMP/*.prog"
+
+printf "%-20s" "model"
+for n in $COUNTS; do printf "%10s" "-j $n"; done
+echo
+for model in $MODELS; do
+    printf "%-20s" "$(basename $model .prog)"
+    for n in $COUNTS; do
+        start=$(date +%s%N)
+        $BIN $model --all --full --no-color --threads $n > /dev/null
+        end=$(date +%s%N)
+        awk "BEGIN { printf \"%9.3fs\", ($end - $start) / 1e9 }"
+    done
+    echo
+done
@@ -0,0 +1,364 @@
+#include "argparse.h"
+#include "prelude.h"
+
+typedef struct {
+    char* long_name;
+    char short_name;
+    Option option;
+    char* help_message;
+} Flag;
+
+Flag opt_flags [] = {
+    { "ast", 'a', SHOW_AST, "Pretty-print the syntax tree" },
+    { "repr", 'r', SHOW_REPR, "Pretty-print the internal graph representation" },
+    { "dot", 'd', SHOW_DOT, "Dump graphviz file and render as png" },
+    { "rand", 'R', EXEC_RAND, "Perform Monte-Carlo execution" },
+    { "all", 'A', EXEC_ALL, "Perform exhaustive execution" },
+    { "por", 'p', PARTIAL_ORDER, "Skip redundant interleavings during --all" },
+    { "symmetry", 's', SYMMETRY, "Identify permutations of identical processes" },
+    { "compact", 'C', COMPACT, "Merge steps on local variables into atomic blocks" },
+    { "collapse", 'z', COLLAPSE, "Compress visited states process by process" },
+    { "full", 'F', FULL, "Keep exploring once --all satisfied every check" },
+    { "stats", 'v', SHOW_STATS, "Report the work done by --rand or --all" },
+    { "profile", 'o', PROFILE, "Count the work done by --all for each step and guard" },
+    { "adaptive", 'y', ADAPTIVE, "Stop --rand once it stops finding anything new" },
+    { "swarm", 'W', SWARM, "Vary the scheduling strategy of each random walk" },
+    { "no-simplify", 'S', NO_SIMPLIFY, "Do not rewrite expressions before execution" },
+    { "trace", 't', SHOW_TRACE, "Show sequence of steps to satisfy checks" },
+    { "no-color", 'c', NO_COLOR, "Do not use ANSI color codes in pretty-prints" },
+    { "help", 'h', HELP, "Show help message and exit" },
+    { NULL, 0, 0, NULL },
+};
+
+typedef struct {
+    char* long_name;
+    char short_name;
+    Param param;
+    char* metavar;
+    bool numeric;
+    char** choices; // accepted values, NULL for any
+    char* help_message;
+} ParamFlag;
+
+// Same order as Search in exec.h
+char* search_modes [] = { "bfs", "dfs", "iddfs", "best", NULL };
+
+ParamFlag opt_params [] = {
+    { "threads", 'j', THREADS, "N", true, NULL, "Number of threads for execution" },
+    { "seed", 'x', SEED, "N", true, NULL, "Seed of the random execution" },
+    { "walks", 'w', WALKS, "N", true, NULL, "Number of random walks (default 100)" },
+    { "depth", 'l', DEPTH, "N", true, NULL, "Steps per random walk (default 100)" },
+    { "time-budget", 'T', TIME_BUDGET, "SECONDS", true, NULL, "Time limit of the random execution" },
+    { "search", 'k', SEARCH, "MODE", false, search_modes, "Order of --all: bfs (default), dfs, iddfs, best" },
+    { "target", 'g', TARGET, "LIST", false, NULL, "Checks that --all must satisfy before stopping" },
+    { "range-max", 'n', RANGE_MAX, "N", true, NULL, "Values of a range explored by --all (default 1024)" },
+    { "progress", 'P', PROGRESS, "SECONDS", true, NULL, "Report the progress of --all every SECONDS" },
+    { "checkpoint", 'K', CHECKPOINT, "FILE", false, NULL, "Save the progress of --all to FILE now and then" },
+    { "checkpoint-every", 'I', CHECKPOINT_EVERY, "SECONDS", true, NULL, "Time between checkpoints (default 300)" },
+    { "resume", 'u', RESUME, "FILE", false, NULL, "Resume --all from the checkpoint in FILE" },
+    { "external-dir", 'e', EXTERNAL_DIR, "DIR", false, NULL, "Keep the states of --all on disk in DIR" },
+    { "external-mem", 'm', EXTERNAL_MEM, "MB", true, NULL, "Memory for sorting with --external-dir" },
+    { "bitstate", 'b', BITSTATE, "MB", true, NULL, "Approximate set of visited states for --all" },
+    { NULL, 0, 0, NULL, false, NULL, NULL },
+};
+
+void show_help () {
+    printf("lang\n");
+    printf("  Parser, pretty-printer and simulator\n");
+    printf("\n");
+    printf("  Usage: lang [FILE] [FLAGS]\n");
+    printf("  Flags:\n");
+    // names of parameters are followed by their metavar,
+    // messages are aligned to the right
+    int width = 0;
+    int help_width = 0;
+    for (uint j = 0; opt_flags[j].long_name; j++) {
+        int len = (int)strlen(opt_flags[j].long_name);
+        if (len > width) width = len;
+        len = (int)strlen(opt_flags[j].help_message);
+        if (len > help_width) help_width = len;
+    }
+    for (uint j = 0; opt_params[j].long_name; j++) {
+        int len = (int)(strlen(opt_params[j].long_name) + 1 + strlen(opt_params[j].metavar));
+        if (len > width) width = len;
+        len = (int)strlen(opt_params[j].help_message);
+        if (len > help_width) help_width = len;
+    }
+    for (uint j = 0; opt_flags[j].long_name; j++) {
+        printf("    -%c, --%-*s   %*s\n",
+            opt_flags[j].short_name,
+            width, opt_flags[j].long_name,
+            help_width, opt_flags[j].help_message);
+    }
+    for (uint j = 0; opt_params[j].long_name; j++) {
+        char name [width + 1];
+        snprintf(name, sizeof(name), "%s %s",
+            opt_params[j].long_name, opt_params[j].metavar);
+        printf("    -%c, --%-*s   %*s\n",
+            opt_params[j].short_name,
+            width, name,
+            help_width, opt_params[j].help_message);
+    }
+    printf("  Examples:\n");
+    printf("      lang -ar input.prog --no-color\n");
+    printf("      lang input.prog --rand --all -c -t\n");
+    printf("      lang input.prog --all --threads 8\n");
+    printf("      lang input.prog --all --external-dir /tmp/states\n");
+    printf("      lang -h");
+}
+
+// handle argument of the form -XYZ
+uint multiflags (char* c) {
+    uint acc = 0;
+    for (; *c; c++) {
+        uint j;
+        for (j = 0; opt_flags[j].long_name; j++) {
+            if (*c == opt_flags[j].short_name) {
+                if (acc & opt_flags[j].option) {
+                    fprintf(stderr, "Warning: duplicate flag '%c' is ignored\n", *c);
+                }
+                acc |= opt_flags[j].option;
+                break;
+            }
+        }
+        if (!opt_flags[j].long_name) {
+            fprintf(stderr, "Unknown flag '%c'\n", *c);
+            return 0;
+        }
+    }
+    return acc;
+}
+
+uint find_option (char* arg) {
+    if (arg[1] == '-') { // caller must check arg[0] == '-'
+        for (uint j = 0; opt_flags[j].long_name; j++) {
+            if (0 == strcmp(arg+2, opt_flags[j].long_name)) {
+                return opt_flags[j].option;
+            }
+        }
+        return 0;
+    }
+    return multiflags(arg+1);
+}
+
+// handle argument of the form -X or --long that expects a value
+// returns -1 if there is no such parameter
+int find_param (char* arg) {
+    for (int j = 0; opt_params[j].long_name; j++) {
+        if (arg[1] == '-'
+            ? 0 == strcmp(arg+2, opt_params[j].long_name)
+            : arg[1] == opt_params[j].short_name && !arg[2]
+        ) {
+            return j;
+        }
+    }
+    return -1;
+}
+
+bool is_number (char* str) {
+    if (!*str) return false;
+    for (; *str; str++) {
+        if (*str < '0' || *str > '9') return false;
+    }
+    return true;
+}
+
+// -1 if `val` is not among `choices`
+int get_choice_index (char** choices, char* val) {
+    for (int c = 0; choices[c]; c++) {
+        if (0 == strcmp(val, choices[c])) return c;
+    }
+    return -1;
+}
+
+Args* parse_args (int argc, char** argv) {
+    Args* args = malloc(sizeof(Args));
+    args->fname_src = NULL;
+    args->flags = 0;
+    for (uint p = 0; p < NB_PARAM; p++) args->params[p] = NULL;
+    for (int i = 1; i < argc; i++) {
+        int j;
+        if (argv[i][0] == '-' && (j = find_param(argv[i])) >= 0) {
+            ParamFlag* param = opt_params + j;
+            if (i + 1 == argc) {
+                fprintf(stderr, "Option '%s' expects a value %s\n", argv[i], param->metavar);
+                show_help();
+                free(args);
+                return NULL;
+            }
+            char* val = argv[++i];
+            if (param->numeric && !is_number(val)) {
+                fprintf(stderr, "Option '%s' expects a number, found '%s'\n", argv[i-1], val);
+                show_help();
+                free(args);
+                return NULL;
+            }
+            if (param->choices && get_choice_index(param->choices, val) < 0) {
+                fprintf(stderr, "Option '%s' expects one of", argv[i-1]);
+                for (uint c = 0; param->choices[c]; c++) fprintf(stderr, " %s", param->choices[c]);
+                fprintf(stderr, ", found '%s'\n", val);
+                show_help();
+                free(args);
+                return NULL;
+            }
+            if (args->params[param->param]) {
+                fprintf(stderr,
+                    "Warning: duplicate option '%s' overrides previous value\n",
+                    argv[i-1]);
+            }
+            args->params[param->param] = val;
+        } else if (argv[i][0] == '-') {
+            uint opt = find_option(argv[i]);
+            if (opt) {
+                if (args->flags & opt) {
+                    fprintf(stderr,
+                        "Warning: duplicate flag '%s' is ignored\n",
+                        argv[i]);
+                }
+                args->flags |= opt;
+            } else {
+                fprintf(stderr, "No such option '%s'\n", argv[i]);
+                show_help();
+                free(args);
+                return NULL;
+            }
+        } else {
+            if (args->fname_src) {
+                fprintf(stderr,
+                    "Warning: duplicate filename '%s' is ignored\n",
+                    argv[i]);
+            } else {
+                args->fname_src = argv[i];
+            }
+        }
+    }
+    if ((args->flags&SHOW_TRACE)
+        && !(args->flags&EXEC_RAND)
+        && !(args->flags&EXEC_ALL)) {
+            fprintf(stderr,
+                "Warning: --trace is useless without either --rand or --all\n");
+    }
+    if ((args->flags&PARTIAL_ORDER) && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --por is useless without --all\n");
+    }
+    if ((args->flags&SYMMETRY) && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --symmetry is useless without --all\n");
+    }
+    if ((args->flags&COMPACT) && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --compact is useless without --all\n");
+    }
+    if ((args->flags&SHOW_STATS) && !(args->flags&EXEC_ALL) && !(args->flags&EXEC_RAND)) {
+        fprintf(stderr, "Warning: --stats is useless without either --rand or --all\n");
+    }
+    if ((args->flags&PROFILE) && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --profile is useless without --all\n");
+    }
+    if ((args->flags&ADAPTIVE) && !(args->flags&EXEC_RAND)) {
+        fprintf(stderr, "Warning: --adaptive is useless without --rand\n");
+    }
+    if ((args->flags&SWARM) && !(args->flags&EXEC_RAND)) {
+        fprintf(stderr, "Warning: --swarm is useless without --rand\n");
+    }
+    if (args->params[WALKS] && !(args->flags&EXEC_RAND)) {
+        fprintf(stderr, "Warning: --walks is useless without --rand\n");
+    }
+    if (args->params[DEPTH] && !(args->flags&EXEC_RAND)) {
+        fprintf(stderr, "Warning: --depth is useless without --rand\n");
+    }
+    if (args->params[TIME_BUDGET] && !(args->flags&EXEC_RAND)) {
+        fprintf(stderr, "Warning: --time-budget is useless without --rand\n");
+    }
+    if (args->params[THREADS] && !(args->flags&EXEC_ALL) && !(args->flags&EXEC_RAND)) {
+        fprintf(stderr, "Warning: --threads is useless without either --rand or --all\n");
+    }
+    if (args->params[SEED] && !(args->flags&EXEC_RAND)) {
+        fprintf(stderr, "Warning: --seed is useless without --rand\n");
+    }
+    if (args->params[EXTERNAL_DIR] && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --external-dir is useless without --all\n");
+    }
+    if ((args->flags&COLLAPSE) && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --collapse is useless without --all\n");
+    }
+    if ((args->flags&COLLAPSE) && args->params[BITSTATE]) {
+        fprintf(stderr, "Warning: --collapse is useless with --bitstate\n");
+    }
+    if (args->params[BITSTATE] && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --bitstate is useless without --all\n");
+    }
+    if ((args->flags&FULL) && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --full is useless without --all\n");
+    }
+    if (args->params[TARGET] && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --target is useless without --all\n");
+    }
+    if (args->params[TARGET] && (args->flags&FULL)) {
+        fprintf(stderr, "Warning: --target is useless with --full\n");
+    }
+    if (args->params[SEARCH] && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --search is useless without --all\n");
+    }
+    if (args->params[SEARCH] && strcmp(args->params[SEARCH], "bfs")) {
+        bool depth_first = strcmp(args->params[SEARCH], "best");
+        if (depth_first && (args->flags&PARTIAL_ORDER)) {
+            fprintf(stderr, "Warning: --por is useless with --search %s\n", args->params[SEARCH]);
+        }
+        if (depth_first && (args->flags&COMPACT)) {
+            fprintf(stderr, "Warning: --compact is useless with --search %s\n", args->params[SEARCH]);
+        }
+        if (args->params[THREADS]) {
+            fprintf(stderr, "Warning: --threads is useless with --search %s\n", args->params[SEARCH]);
+        }
+    }
+    if (args->params[SEARCH] && !strcmp(args->params[SEARCH], "iddfs") && args->params[BITSTATE]) {
+        fprintf(stderr, "Warning: --bitstate is useless with --search iddfs\n");
+    }
+    if (args->params[RANGE_MAX] && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --range-max is useless without --all\n");
+    }
+    if ((args->params[CHECKPOINT] || args->params[RESUME]) && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --checkpoint and --resume are useless without --all\n");
+    }
+    if ((args->params[CHECKPOINT] || args->params[RESUME])
+        && ((args->params[SEARCH] && strcmp(args->params[SEARCH], "bfs"))
+            || args->params[EXTERNAL_DIR] || ((args->flags&COLLAPSE) && !args->params[BITSTATE]))
+    ) {
+        fprintf(stderr, "Warning: --checkpoint and --resume only apply to --search bfs in memory without --collapse\n");
+    }
+    if (args->params[CHECKPOINT_EVERY] && !args->params[CHECKPOINT] && !args->params[RESUME]) {
+        fprintf(stderr, "Warning: --checkpoint-every is useless without --checkpoint\n");
+    }
+    if (args->params[PROGRESS] && !(args->flags&EXEC_ALL)) {
+        fprintf(stderr, "Warning: --progress is useless without --all\n");
+    }
+    if (args->params[EXTERNAL_MEM] && !args->params[EXTERNAL_DIR]) {
+        fprintf(stderr, "Warning: --external-mem is useless without --external-dir\n");
+    }
+    if (args->flags&HELP) {
+        show_help();
+        free(args);
+        return NULL;
+    }
+    if (!args->fname_src) {
+        fprintf(stderr, "No file specified\n");
+        show_help();
+        free(args);
+        return NULL;
+    }
+    return args;
+}
+
+ull get_param (Args* args, Param param, ull dflt) {
+    if (!args->params[param]) return dflt;
+    return strtoull(args->params[param], NULL, 10);
+}
+
+uint get_choice (Args* args, Param param, uint dflt) {
+    if (!args->params[param]) return dflt;
+    for (uint j = 0; opt_params[j].long_name; j++) {
+        if (opt_params[j].param == param) {
+            return (uint)get_choice_index(opt_params[j].choices, args->params[param]);
+        }
+    }
+    UNREACHABLE("%d is not a parameter", param);
+}
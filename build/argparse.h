@@ -0,0 +1,67 @@
+#ifndef ARGPARSE_H
+#define ARGPARSE_H
+
+#include "prelude.h"
+
+// produce unique increasing bitflags
+enum { COUNTER_BASE = __COUNTER__ };
+#define BITFLAG_UNIQUE(e) e = 1 << (__COUNTER__ - COUNTER_BASE - 1)
+
+typedef enum Option {
+    BITFLAG_UNIQUE(SHOW_AST),
+    BITFLAG_UNIQUE(SHOW_REPR),
+    BITFLAG_UNIQUE(SHOW_DOT),
+    BITFLAG_UNIQUE(EXEC_RAND),
+    BITFLAG_UNIQUE(EXEC_ALL),
+    BITFLAG_UNIQUE(PARTIAL_ORDER),
+    BITFLAG_UNIQUE(SYMMETRY),
+    BITFLAG_UNIQUE(COMPACT),
+    BITFLAG_UNIQUE(COLLAPSE),
+    BITFLAG_UNIQUE(FULL),
+    BITFLAG_UNIQUE(SHOW_STATS),
+    BITFLAG_UNIQUE(PROFILE),
+    BITFLAG_UNIQUE(ADAPTIVE),
+    BITFLAG_UNIQUE(SWARM),
+    BITFLAG_UNIQUE(NO_SIMPLIFY),
+    BITFLAG_UNIQUE(SHOW_TRACE),
+    BITFLAG_UNIQUE(NO_COLOR),
+    BITFLAG_UNIQUE(HELP),
+} Option;
+
+// options that take a value
+typedef enum Param {
+    THREADS,
+    EXTERNAL_DIR,
+    EXTERNAL_MEM,
+    BITSTATE,
+    SEED,
+    WALKS,
+    DEPTH,
+    TIME_BUDGET,
+    SEARCH,
+    TARGET,
+    RANGE_MAX,
+    PROGRESS,
+    CHECKPOINT,
+    CHECKPOINT_EVERY,
+    RESUME,
+    NB_PARAM, // not an option, number of options
+} Param;
+
+typedef struct {
+    char* fname_src;
+    uint flags;
+    char* params [NB_PARAM]; // NULL when not specified
+} Args;
+
+void show_help ();
+
+Args* parse_args (int argc, char** argv);
+
+// Numeric value of a parameter (already validated by parse_args)
+ull get_param (Args* args, Param param, ull dflt);
+// Position of the value of a parameter among its accepted values
+uint get_choice (Args* args, Param param, uint dflt);
+
+#undef BITFLAG_UNIQUE
+#endif // ARGPARSE_H
@@ -0,0 +1,83 @@
+#include "ast.h"
+#include "prelude.h"
+#include "memreg.h"
+
+Arena* ast_arena = NULL;
+Arena* var_arena = NULL;
+
+void* alloc_ast (size_t size) { return arena_alloc(&ast_arena, size); }
+void* alloc_var (size_t size) { return arena_alloc(&var_arena, size); }
+void free_ast () { arena_free(&ast_arena); }
+void free_var () { arena_free(&var_arena); }
+
+// Parse-time expression builders
+// (also handle allocating from the arenas)
+
+Var* make_ident (char* name, uint id) {
+    Var* var = alloc_var(sizeof(Var));
+    var->name = arena_strdup(&var_arena, name);
+    var->next = NULL;
+    var->id = id;
+    return var;
+}
+
+Prog* make_prog (Var* globs, Proc* procs, Check* checks) {
+    Prog* prog = alloc_ast(sizeof(Prog));
+    prog->globs = globs;
+    prog->procs = procs;
+    prog->checks = checks;
+    return prog;
+}
+
+Assign* make_assign (char* target, Expr* value) {
+    Assign* assign = alloc_ast(sizeof(Assign));
+    assign->target = target;
+    assign->value = value;
+    return assign;
+}
+
+Branch* make_branch (Expr* cond, Stmt* stmt) {
+    Branch* branch = alloc_ast(sizeof(Branch));
+    branch->cond = cond;
+    branch->stmt = stmt;
+    branch->next = NULL;
+    return branch;
+}
+
+Stmt* make_stmt (StmtKind type, uint id) {
+    Stmt* stmt = alloc_ast(sizeof(Stmt));
+    stmt->type = type;
+    stmt->next = NULL;
+    stmt->id = id;
+    return stmt;
+}
+
+Proc* make_proc (char* name, Var* locs, Stmt* stmts) {
+    Proc* proc = alloc_ast(sizeof(Proc));
+    proc->name = name;
+    proc->locs = locs;
+    proc->stmts = stmts;
+    proc->next = NULL;
+    return proc;
+}
+
+Binop* make_binop (Expr* lhs, Expr* rhs) {
+    Binop* binop = alloc_ast(sizeof(Binop));
+    binop->lhs = lhs;
+    binop->rhs = rhs;
+    return binop;
+}
+
+Expr* make_expr (ExprKind type) {
+    Expr* expr = alloc_ast(sizeof(Expr));
+    expr->type = type;
+    return expr;
+}
+
+Check* make_check (Expr* cond) {
+    Check* check = alloc_ast(sizeof(Check));
+    check->cond = cond;
+    check->next = NULL;
+    return check;
+}
+
@@ -0,0 +1,60 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "exec.h"
+#include "hashset.h"
+#include "prelude.h"
+#include <sys/types.h>
+
+// Checkpoints of the breadth-first exploration, so that a long run that
+// is interrupted can be resumed from its last checkpoint (--resume).
+//
+// A checkpoint is taken between two levels, when no thread is running:
+// the process forks and the child writes the snapshot that it inherited
+// while the parent goes on with the next level. The file is written
+// under a temporary name then renamed, so that it always holds a
+// complete checkpoint.
+//
+// It holds, in this order:
+// - a header that identifies the program, down to the code of its
+//   assignments, guards and checks and the successors of its steps, and
+//   the options that change which states are visited (a checkpoint is
+//   only resumed with them)
+// - the counters of the exploration and when each check was satisfied
+// - the visited states with their hash, or the bits of the bitstate set
+// - the diffs that lead to the next level and to the witnesses, each
+//   after its parent, referred to by their position (0 for none)
+// - the witness of each check
+// - the next level: the diff and the vector of each state
+//
+// Collapse compression is not supported.
+
+// Everything but the sets and the level
+typedef struct {
+    uint depth; // of the next level
+    ull nbstate;
+    double nbrepr;
+    ull nbfused;
+    ull nbtrans;
+    ull maxfrontier;
+    double seconds; // since the exploration started
+    double* found_at; // one per check
+    Sat* sat;
+} Snapshot;
+
+// Write the checkpoint from a child process, returns its pid (-1 on failure)
+// `level` holds `level_size` chunks, exactly one of `seen` and `bits` is not NULL
+pid_t save_checkpoint (
+    char* fname, RProg* prog, ExecOpts* opts, Snapshot* snap,
+    SharedSet* seen, BitState* bits, Chunk** level, ull level_size
+);
+
+// Fill the sets and `todo` with the checkpoint, and `snap` whose
+// `found_at` and `sat` must be allocated already
+// Returns false and prints why if it cannot be read
+bool load_checkpoint (
+    char* fname, RProg* prog, ExecOpts* opts, Snapshot* snap,
+    SharedSet* seen, BitState* bits, WorkList* todo
+);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,184 @@
+#ifndef EXEC_H
+#define EXEC_H
+
+#include "repr.h"
+#include "layout.h"
+#include "prelude.h"
+#include <time.h>
+
+struct Compute;
+struct Diff;
+typedef struct Diff* Sat;
+// NULL if not satisfied, otherwise pointer
+// to a computation state that satisfies
+// the condition
+
+// A state of the computation
+// Allocated in one block: the packed vector follows the header
+typedef struct Compute {
+    Sat* sat; // satisfied checks
+    RProg* prog;
+    struct Diff* diff; // which state this was forked from
+    ull hashed; // kept up to date during exhaustive exploration (see hashset.h)
+    ull vec []; // value of each variable and step of each process
+} Compute;
+
+typedef struct Diff {
+    struct Diff* parent;
+    uint pid_advance;
+    RStep* new_step;
+    Var* var_assign;
+    int val_assign;
+    uint depth; // in order to find shortest path
+} Diff;
+
+void copy_compute (Compute* dst, Compute* src);
+void free_compute (Compute* comp);
+
+// All variables 0, all processes at their entrypoint
+void init_vec (RProg* prog, Vec vec);
+
+Compute* make_compute (RProg* prog, Sat* sat);
+Sat* blank_sat (RProg* prog);
+// Allocated along with the results, freed by free_sat
+Diff* make_sat_diff (Diff* parent);
+void* alloc_sat (size_t size);
+
+// Seconds since `start` (CLOCK_MONOTONIC)
+double elapsed (struct timespec* start);
+// Largest resident memory of the process so far, in kilobytes
+long peak_memory ();
+// One line on stderr for --progress
+void print_progress (double now, ull nbstate, ull nbtrans, uint depth, ull frontier);
+
+// A transition of one process during the exhaustive exploration:
+// the step it moves to, the guard it goes through (NULL for an
+// unguarded step or an else clause) and, if the step it leaves has
+// an assignment, the value assigned
+typedef struct {
+    RStep* step;
+    RGuard* guard;
+    int val;
+} Succ;
+
+// Values of a range considered by the exhaustive exploration at most,
+// and whether some were dropped because of it (see exec_code_all)
+extern uint range_max;
+extern bool range_truncated;
+
+// Room for the exhaustive evaluation of ranges (see exec_code_all),
+// reused by every evaluation of a thread
+typedef struct {
+    int* work; // sets of values of the registers
+    uint work_size;
+    int* vals; // values of an expression
+    uint nbval;
+    Succ* succs; // transitions of a step
+    uint nbsucc;
+} EvalBuf;
+
+// Sized for the guards, assignments and checks of `prog`
+// (requires `range_max` to be set)
+EvalBuf* create_evalbuf (RProg* prog);
+// Make room for evaluating `code` as well
+void fit_evalbuf (EvalBuf* buf, struct Code* code);
+void free_evalbuf (EvalBuf* buf);
+
+// Values of a nondeterministic expression, in `buf->vals`
+uint all_values (EvalBuf* buf, struct Code* code, Vec vec);
+
+// Whether some choice of the ranges of a guard or check satisfies it
+bool holds (EvalBuf* buf, struct Code* code, Vec vec);
+
+// Room needed by `next_steps` for the successors of `step`
+uint max_next (RStep* step);
+
+// List the transitions of `step` from the state `vec` in `next`
+// (`buf->succs` will do): one per value of the assignment (which is
+// not executed), or one per satisfied guard
+// Returns how many there are, 0 if the step is blocked
+uint next_steps (EvalBuf* buf, RStep* step, Vec vec, Succ* next);
+
+// Order in which the exhaustive exploration visits states
+typedef enum {
+    SEARCH_BFS, // breadth-first, shortest traces
+    SEARCH_DFS, // depth-first, memory proportional to the depth
+    SEARCH_IDDFS, // depth-first with an increasing depth bound, shortest traces
+    SEARCH_BEST, // most promising states first (see heuristic.h)
+} Search;
+
+// Parameters of the exhaustive exploration
+typedef struct {
+    Search search;
+    uint threads;
+    bool por; // partial order reduction
+    bool symmetry; // identify permutations of identical processes
+    bool compact; // run fusible steps along with their predecessor
+    char* external_dir; // keep states on disk (see external.h), NULL for in memory
+    ull external_mem; // bytes of successors sorted in memory at once
+    ull bitstate; // bits of the approximate set of visited states, 0 for an exact set
+    bool collapse; // intern the component of each process (see hashset.h)
+    bool* targets; // stop once these checks are satisfied, NULL for all of them
+    bool full; // do not stop, explore every state
+    uint range_max; // values of a range at most
+    uint progress; // seconds between progress lines on stderr, 0 for none
+    bool profile; // count the work done for each step and guard (see profile.h)
+    char* checkpoint; // file of the checkpoints (see checkpoint.h), NULL for none
+    ull checkpoint_every; // seconds between checkpoints
+    char* resume; // checkpoint to start from, NULL to start from the initial state
+} ExecOpts;
+
+// Results of the exhaustive exploration other than checks
+typedef struct {
+    ull nbstate; // distinct states visited
+    double nbrepr; // number of states they stand for (differs with symmetry)
+    ull nbfused; // steps executed without storing the intermediate state
+    double omission; // probability that a new state was taken for a visited one
+    ull nbcomp; // process components interned with collapse
+    double compression; // memory of visited states without collapse over with it
+    uint nbbound; // depth bounds tried with SEARCH_IDDFS
+    uint maxdepth; // deepest state expanded (longest path kept on the stack with SEARCH_DFS or SEARCH_IDDFS)
+    ull nbtrans; // transitions executed, whether they led to a new state or not
+    ull maxfrontier; // states waiting to be expanded at once, at most
+    // set of visited states (in memory only)
+    double load; // keys per slot (bits set per bit with bitstate)
+    double probes; // slots inspected per lookup
+    double collisions; // fraction of the lookups whose first slot held another state
+    double bytes; // memory per state, including collapse tables
+    long peak_kb; // resident memory of the process at most
+    struct Profile* profile; // with opts.profile, to be freed by the caller, NULL otherwise
+    double seconds;
+    double* found_at; // seconds until each check was satisfied, -1 if it was not
+    bool stopped; // before every state was explored, since all targets were satisfied
+    bool truncated; // some values of a range were not explored
+} ExecStats;
+
+// Recursive evaluation of an expression, INT_MIN on division by zero
+int eval_expr (RExpr* expr, RProg* prog, Vec vec);
+
+// Parameters of the random execution
+typedef struct {
+    uint threads;
+    ull seed; // a run is replayed from its seed
+    uint walks; // maximum number of walks
+    uint depth; // steps per walk
+    ull time_budget; // seconds before no new walk is started, 0 for none
+    bool adaptive; // stop once all checks are satisfied or few new states are found
+    bool swarm; // each walk draws its own scheduling strategy and depth
+} RandOpts;
+
+// Results of the random execution other than checks
+typedef struct {
+    ull nbwalk;
+    ull nbstep;
+    double seconds;
+    ull nbstate; // distinct states visited (only in adaptive mode)
+} RandStats;
+
+Sat* exec_prog_random (RProg* prog, RandOpts* opts, RandStats* stats);
+// NULL if the exploration could not be completed
+// (only possible with external_dir)
+Sat* exec_prog_all (RProg* prog, ExecOpts* opts, ExecStats* stats);
+void free_sat (); // to be called when the reachabilities have been printed
+
+#endif // EXEC_H
@@ -0,0 +1,27 @@
+#ifndef EXTERNAL_H
+#define EXTERNAL_H
+
+#include "exec.h"
+#include "prelude.h"
+
+// Exhaustive exploration with the states kept on disk, for state spaces
+// that do not fit in memory.
+//
+// The search is a breadth-first search layer by layer, with delayed
+// duplicate detection: the successors of a layer are written to sorted
+// runs of bounded size, the runs are merged, and the states found in
+// one of the sorted files of the states visited so far are removed
+// to obtain the next layer. Each layer then becomes a visited file.
+// Files are merged a bounded number at a time: the runs in several
+// passes if there are too many of them, the visited files into a
+// single one once there are too many of them.
+//
+// Each state of a layer records the index of its parent in the previous
+// layer and the step that led to it, so that traces can be rebuilt
+// at the end by reading the layers backwards.
+//
+// Partial order reduction, symmetry reduction, compaction and threads
+// are not available in this mode.
+Sat* exec_prog_external (RProg* prog, ExecOpts* opts, ExecStats* stats);
+
+#endif // EXTERNAL_H
@@ -0,0 +1,756 @@
+#include "hashset.h"
+#include "prelude.h"
+#include <pthread.h>
+
+const ull MUL = 0x100000001b3;
+const ull INIT = 0xcbf29ce484222325;
+
+// Initial number of slots, must be a power of 2
+const ull INIT_CAPACITY = 256;
+
+// Open addressing with linear probing.
+// Keys are stored inline in a single buffer so that inserting
+// a new state never requires an allocation (except when the
+// table grows). The stored hash doubles as an occupancy marker:
+// hashes are never 0 so 0 means an empty slot.
+struct HashSet {
+    uint width; // number of words in each key
+    uint stride; // words in each slot: the key, then its values (see create_hashmap)
+    ull capacity; // always a power of 2
+    ull nb_elem;
+    ull* hashes;
+    ull* keys; // capacity * stride words
+    // see SetStats
+    ull lookups;
+    ull probes;
+    ull displaced;
+#if HASHSET_SHOW_STATS
+    ull collisions;
+    uint resizes;
+#endif // HASHSET_SHOW_STATS
+};
+
+// Shards are selected by the high bits of the hash,
+// slots inside a shard by the low bits
+struct SharedSet {
+    uint nbshard;
+    HashSet** shards;
+    pthread_mutex_t* locks; // NULL when single-threaded
+};
+
+// Enough shards that two threads rarely wait for the same one
+const uint SHARDS_PER_THREAD = 16;
+
+// Bits set for each key of a bitstate set
+const uint BITSTATE_HASHES = 3;
+
+// Bits are selected by double hashing on the full hash
+// (no key is stored at all)
+struct BitState {
+    ull mask; // number of bits - 1, a power of 2 - 1
+    ull* words;
+    ull nbset; // bits set to 1
+};
+
+// Components wider than this are interned, the others are stored as is
+// (also the width of an index)
+const uint COLLAPSE_MAX_INLINE = 32;
+
+// Components in order of creation, their index is their position
+// Slots hold index + 1 (0 for empty)
+typedef struct {
+    uint width; // words per component
+    ull nb;
+    ull capacity; // slots, always a power of 2
+    uint* slots;
+    ull* comps; // capacity / 2 * width words
+    pthread_mutex_t lock;
+} Intern;
+
+struct Collapse {
+    Layout* layout;
+    uint nbglob;
+    Field* globs; // fields of the global variables
+    uint nbproc;
+    uint* nbfield; // per process
+    Field** fields; // step then locals of each process
+    uint* bits; // width of the component of each process
+    Intern** tables; // NULL for components stored inline
+    uint width; // words in a collapsed key
+    bool shared; // lock the tables
+};
+
+// Number of states in a chunk of the worklist
+const uint CHUNK_LEN = 256;
+
+// States of the worklist are stored by value: each entry is the diff
+// pointer and the hash followed by the packed vector
+struct Chunk {
+    uint len; // entries written
+    uint read; // entries already dequeued
+    uint stride; // words per entry
+    struct Chunk* next;
+    ull data [];
+};
+
+// Queue : new elements at the end
+// -> guarantees shortest path is found
+// Drained chunks are kept aside to be filled again
+struct WorkList {
+    uint stride;
+    Chunk* head;
+    Chunk* tail;
+    Chunk* spare;
+};
+
+// Binary heap ordered by priority, then by order of insertion
+// Each entry is the priority, the insertion number, the diff pointer
+// and the hash followed by the packed vector
+struct Frontier {
+    uint stride;
+    ull size;
+    ull capacity;
+    ull seq; // entries pushed so far
+    ull* data;
+};
+
+// States are stored as their packed vector
+uint key_width (RProg* prog) {
+    return prog->layout->nbword;
+}
+
+// FNV-style accumulation followed by a final avalanche so that
+// the low bits (used to select a slot) depend on the whole key
+ull hash_key (ull* key, uint width) {
+    ull h = INIT;
+    for (uint i = 0; i < width; i++) {
+        h = (h ^ key[i]) * MUL;
+        h ^= h >> 29;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    return h ? h : 1; // 0 is reserved for empty slots
+}
+
+ull hash (Compute* item) {
+    return hash_key(item->vec, key_width(item->prog));
+}
+
+ull hash_fields (RProg* prog, Vec vec) {
+    Layout* layout = prog->layout;
+    ull h = 0;
+    for (uint i = 0; i < prog->nbvar; i++) {
+        h += hash_field(i, get_field(layout->vars + i, vec));
+    }
+    for (uint p = 0; p < prog->nbproc; p++) {
+        h += hash_field(prog->nbvar + p, get_field(layout->procs + p, vec));
+    }
+    return h;
+}
+
+bool equals (Compute* lhs, Compute* rhs) {
+    return memcmp(lhs->vec, rhs->vec, key_width(lhs->prog) * sizeof(ull)) == 0;
+}
+
+// Allocate set buffer and mark all slots empty
+HashSet* create_hashset (uint width) {
+    return create_hashmap(width, 0);
+}
+
+HashSet* create_hashmap (uint width, uint nbval) {
+    HashSet* set = malloc(sizeof(HashSet));
+    set->width = width;
+    set->stride = width + nbval;
+    set->capacity = INIT_CAPACITY;
+    set->nb_elem = 0;
+    set->hashes = calloc(set->capacity, sizeof(ull));
+    set->keys = malloc(set->capacity * set->stride * sizeof(ull));
+    set->lookups = 0;
+    set->probes = 0;
+    set->displaced = 0;
+#if HASHSET_SHOW_STATS
+    set->collisions = 0;
+    set->resizes = 0;
+#endif // HASHSET_SHOW_STATS
+    return set;
+}
+
+void free_hashset (HashSet* set) {
+#if HASHSET_SHOW_STATS
+    printf("Hashset deallocated\n");
+    printf(" | %llu elements in %llu slots (load %.2f)\n",
+        set->nb_elem, set->capacity, (double)set->nb_elem / (double)set->capacity);
+    printf(" | %llu probes, %llu hash collisions\n", set->probes, set->collisions);
+    printf(" | %u resizes\n", set->resizes);
+#endif // HASHSET_SHOW_STATS
+    free(set->hashes);
+    free(set->keys);
+    free(set);
+}
+
+// Find the slot that holds the key, or the empty slot where it should go
+ull find_slot (HashSet* set, ull* key, ull hashed) {
+    ull mask = set->capacity - 1;
+    ull idx = hashed & mask;
+    ull home = idx;
+    set->lookups++;
+    while (set->hashes[idx]) {
+        set->probes++;
+        if (set->hashes[idx] == hashed) {
+            if (memcmp(set->keys + idx * set->stride, key, set->width * sizeof(ull)) == 0) {
+                return idx;
+            }
+#if HASHSET_SHOW_STATS
+            set->collisions++;
+#endif // HASHSET_SHOW_STATS
+        }
+        if (idx == home) set->displaced++;
+        idx = (idx + 1) & mask;
+    }
+    return idx;
+}
+
+// Double the capacity and move every key to its new slot
+void grow (HashSet* set) {
+    ull old_capacity = set->capacity;
+    ull* old_hashes = set->hashes;
+    ull* old_keys = set->keys;
+    set->capacity *= 2;
+    set->hashes = calloc(set->capacity, sizeof(ull));
+    set->keys = malloc(set->capacity * set->stride * sizeof(ull));
+    ull mask = set->capacity - 1;
+    for (ull i = 0; i < old_capacity; i++) {
+        if (!old_hashes[i]) continue;
+        ull idx = old_hashes[i] & mask;
+        while (set->hashes[idx]) idx = (idx + 1) & mask;
+        set->hashes[idx] = old_hashes[i];
+        memcpy(set->keys + idx * set->stride, old_keys + i * set->stride,
+            set->stride * sizeof(ull));
+    }
+    free(old_hashes);
+    free(old_keys);
+#if HASHSET_SHOW_STATS
+    set->resizes++;
+#endif // HASHSET_SHOW_STATS
+}
+
+// Insert and return true iff absent
+// Load factor is kept below 1/2 to keep probe sequences short
+bool try_insert_key (HashSet* set, ull* key, ull hashed) {
+    ull idx = find_slot(set, key, hashed);
+    if (set->hashes[idx]) return false;
+    set->hashes[idx] = hashed;
+    memcpy(set->keys + idx * set->stride, key, set->width * sizeof(ull));
+    set->nb_elem++;
+    if (2 * set->nb_elem > set->capacity) grow(set);
+    return true;
+}
+
+// Grows beforehand so that the returned slot does not move
+ull* get_or_insert (HashSet* map, ull* key, ull hashed, bool* added) {
+    if (2 * (map->nb_elem + 1) > map->capacity) grow(map);
+    ull idx = find_slot(map, key, hashed);
+    ull* slot = map->keys + idx * map->stride;
+    *added = !map->hashes[idx];
+    if (*added) {
+        map->hashes[idx] = hashed;
+        memcpy(slot, key, map->width * sizeof(ull));
+        memset(slot + map->width, 0, (map->stride - map->width) * sizeof(ull));
+        map->nb_elem++;
+    }
+    return slot + map->width;
+}
+
+ull hashset_size (HashSet* set) {
+    return set->nb_elem;
+}
+
+void hashset_stats (HashSet* set, SetStats* stats) {
+    stats->nbkey += set->nb_elem;
+    stats->capacity += set->capacity;
+    stats->bytes += set->capacity * (set->stride + 1) * sizeof(ull);
+    stats->lookups += set->lookups;
+    stats->probes += set->probes;
+    stats->collisions += set->displaced;
+}
+
+// Insert regardless of presence
+// (a key already present is not duplicated)
+void insert (HashSet* set, Compute* item, ull hashed) {
+    try_insert_key(set, item->vec, hashed);
+}
+
+// Check for presence in set
+bool query (HashSet* set, Compute* item, ull hashed) {
+    return set->hashes[find_slot(set, item->vec, hashed)] != 0;
+}
+
+bool try_insert (HashSet* set, Compute* item) {
+    return try_insert_key(set, item->vec, hash(item));
+}
+
+SharedSet* create_sharedset (uint width, uint nbthread) {
+    SharedSet* set = malloc(sizeof(SharedSet));
+    set->nbshard = (nbthread > 1) ? nbthread * SHARDS_PER_THREAD : 1;
+    set->shards = malloc(set->nbshard * sizeof(HashSet*));
+    for (uint i = 0; i < set->nbshard; i++) {
+        set->shards[i] = create_hashset(width);
+    }
+    if (nbthread > 1) {
+        set->locks = malloc(set->nbshard * sizeof(pthread_mutex_t));
+        for (uint i = 0; i < set->nbshard; i++) {
+            pthread_mutex_init(set->locks + i, NULL);
+        }
+    } else {
+        set->locks = NULL;
+    }
+    return set;
+}
+
+void free_sharedset (SharedSet* set) {
+    for (uint i = 0; i < set->nbshard; i++) {
+        free_hashset(set->shards[i]);
+        if (set->locks) pthread_mutex_destroy(set->locks + i);
+    }
+    free(set->shards);
+    free(set->locks);
+    free(set);
+}
+
+bool try_insert_shared (SharedSet* set, ull* key, ull hashed) {
+    if (!set->locks) return try_insert_key(set->shards[0], key, hashed);
+    uint shard = (uint)((hashed >> 40) % set->nbshard);
+    pthread_mutex_lock(set->locks + shard);
+    bool res = try_insert_key(set->shards[shard], key, hashed);
+    pthread_mutex_unlock(set->locks + shard);
+    return res;
+}
+
+ull sharedset_size (SharedSet* set) {
+    ull nb = 0;
+    for (uint i = 0; i < set->nbshard; i++) nb += set->shards[i]->nb_elem;
+    return nb;
+}
+
+void sharedset_stats (SharedSet* set, SetStats* stats) {
+    for (uint i = 0; i < set->nbshard; i++) hashset_stats(set->shards[i], stats);
+}
+
+void sharedset_foreach (SharedSet* set, void (*fn) (void* ctx, ull* key, ull hashed), void* ctx) {
+    for (uint i = 0; i < set->nbshard; i++) {
+        HashSet* shard = set->shards[i];
+        for (ull idx = 0; idx < shard->capacity; idx++) {
+            if (shard->hashes[idx]) fn(ctx, shard->keys + idx * shard->stride, shard->hashes[idx]);
+        }
+    }
+}
+
+// The size is rounded down to a power of 2
+BitState* create_bitstate (ull nbbit) {
+    ull size = 64;
+    while (size * 2 <= nbbit && size * 2 != 0) size *= 2;
+    BitState* set = malloc(sizeof(BitState));
+    set->mask = size - 1;
+    set->words = calloc(size / 64, sizeof(ull));
+    set->nbset = 0;
+    return set;
+}
+
+void free_bitstate (BitState* set) {
+    free(set->words);
+    free(set);
+}
+
+// Set the bits of the key, returns true iff one of them was not set
+bool try_insert_bits (BitState* set, ull hashed) {
+    ull step = (((hashed >> 32) | (hashed << 32)) * 0x9e3779b97f4a7c15) | 1;
+    uint added = 0;
+    for (uint i = 0; i < BITSTATE_HASHES; i++) {
+        ull idx = (hashed + i * step) & set->mask;
+        ull bit = 1ull << (idx % 64);
+        ull old = __atomic_fetch_or(set->words + idx / 64, bit, __ATOMIC_RELAXED);
+        if (!(old & bit)) added++;
+    }
+    if (!added) return false;
+    __atomic_fetch_add(&set->nbset, added, __ATOMIC_RELAXED);
+    return true;
+}
+
+ull* bitstate_words (BitState* set, ull* nbword) {
+    *nbword = (set->mask + 1) / 64;
+    return set->words;
+}
+
+void bitstate_recount (BitState* set) {
+    set->nbset = 0;
+    for (ull i = 0; i < (set->mask + 1) / 64; i++) {
+        set->nbset += (ull)__builtin_popcountll(set->words[i]);
+    }
+}
+
+void bitstate_stats (BitState* set, SetStats* stats) {
+    stats->nbkey += set->nbset;
+    stats->capacity += set->mask + 1;
+    stats->bytes += (set->mask + 1) / 8;
+}
+
+// All the bits of the new key are already set
+double bitstate_omission (BitState* set) {
+    double fill = (double)set->nbset / (double)(set->mask + 1);
+    double res = 1;
+    for (uint i = 0; i < BITSTATE_HASHES; i++) res *= fill;
+    return res;
+}
+
+// Bit fields are appended one after the other without straddling words
+typedef struct {
+    ull* words;
+    uint word;
+    uint used;
+} Packer;
+
+void pack (Packer* p, ull val, uint width) {
+    if (!width) return;
+    if (p->used + width > 64) {
+        p->word++;
+        p->used = 0;
+    }
+    if (p->words) {
+        if (!p->used) p->words[p->word] = 0;
+        p->words[p->word] |= val << p->used;
+    }
+    p->used += width;
+}
+
+uint packed_words (Packer* p) {
+    return p->word + (p->used ? 1 : 0);
+}
+
+uint field_width (Field* f) {
+    return bit_width(f->mask);
+}
+
+Intern* create_intern (uint width) {
+    Intern* t = malloc(sizeof(Intern));
+    t->width = width;
+    t->nb = 0;
+    t->capacity = INIT_CAPACITY;
+    t->slots = calloc(t->capacity, sizeof(uint));
+    t->comps = malloc(t->capacity / 2 * width * sizeof(ull));
+    pthread_mutex_init(&t->lock, NULL);
+    return t;
+}
+
+void free_intern (Intern* t) {
+    pthread_mutex_destroy(&t->lock);
+    free(t->slots);
+    free(t->comps);
+    free(t);
+}
+
+// Index of the component, added if absent
+// Load factor is kept below 1/2 as in HashSet
+uint intern (Intern* t, ull* comp) {
+    ull mask = t->capacity - 1;
+    ull idx = hash_key(comp, t->width) & mask;
+    while (t->slots[idx]) {
+        uint id = t->slots[idx] - 1;
+        if (memcmp(t->comps + id * t->width, comp, t->width * sizeof(ull)) == 0) return id;
+        idx = (idx + 1) & mask;
+    }
+    // grow first, `comps` has room for capacity/2 components
+    if (2 * (t->nb + 1) > t->capacity) {
+        t->capacity *= 2;
+        mask = t->capacity - 1;
+        free(t->slots);
+        t->slots = calloc(t->capacity, sizeof(uint));
+        t->comps = realloc(t->comps, t->capacity / 2 * t->width * sizeof(ull));
+        for (ull i = 0; i < t->nb; i++) {
+            idx = hash_key(t->comps + i * t->width, t->width) & mask;
+            while (t->slots[idx]) idx = (idx + 1) & mask;
+            t->slots[idx] = (uint)i + 1;
+        }
+        idx = hash_key(comp, t->width) & mask;
+        while (t->slots[idx]) idx = (idx + 1) & mask;
+    }
+    uint id = (uint)t->nb++;
+    t->slots[idx] = id + 1;
+    memcpy(t->comps + id * t->width, comp, t->width * sizeof(ull));
+    return id;
+}
+
+Collapse* create_collapse (RProg* prog, uint nbthread) {
+    Collapse* col = malloc(sizeof(Collapse));
+    Layout* layout = prog->layout;
+    col->layout = layout;
+    col->shared = nbthread > 1;
+    col->nbglob = prog->nbglob;
+    col->globs = malloc((prog->nbglob + 1) * sizeof(Field));
+    Packer key = { NULL, 0, 0 };
+    for (uint i = 0; i < prog->nbglob; i++) {
+        col->globs[i] = layout->vars[prog->globs[i].id];
+        pack(&key, 0, field_width(col->globs + i));
+    }
+    col->nbproc = prog->nbproc;
+    col->nbfield = malloc(prog->nbproc * sizeof(uint));
+    col->fields = malloc(prog->nbproc * sizeof(Field*));
+    col->bits = malloc(prog->nbproc * sizeof(uint));
+    col->tables = malloc(prog->nbproc * sizeof(Intern*));
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        col->nbfield[p] = 1 + proc->nbloc;
+        col->fields[p] = malloc(col->nbfield[p] * sizeof(Field));
+        col->fields[p][0] = layout->procs[p];
+        for (uint i = 0; i < proc->nbloc; i++) {
+            col->fields[p][1 + i] = layout->vars[proc->locs[i].id];
+        }
+        Packer comp = { NULL, 0, 0 };
+        col->bits[p] = 0;
+        for (uint i = 0; i < col->nbfield[p]; i++) {
+            uint width = field_width(col->fields[p] + i);
+            pack(&comp, 0, width);
+            col->bits[p] += width;
+        }
+        if (col->bits[p] > COLLAPSE_MAX_INLINE) {
+            col->tables[p] = create_intern(packed_words(&comp));
+            pack(&key, 0, COLLAPSE_MAX_INLINE);
+        } else {
+            col->tables[p] = NULL;
+            pack(&key, 0, col->bits[p]);
+        }
+    }
+    col->width = packed_words(&key);
+    if (!col->width) col->width = 1;
+    return col;
+}
+
+void free_collapse (Collapse* col) {
+    for (uint p = 0; p < col->nbproc; p++) {
+        free(col->fields[p]);
+        if (col->tables[p]) free_intern(col->tables[p]);
+    }
+    free(col->globs);
+    free(col->nbfield);
+    free(col->fields);
+    free(col->bits);
+    free(col->tables);
+    free(col);
+}
+
+uint collapse_width (Collapse* col) {
+    return col->width;
+}
+
+void collapse (Collapse* col, Vec vec, ull* key) {
+    key[0] = 0; // in case nothing is packed
+    Packer out = { key, 0, 0 };
+    for (uint i = 0; i < col->nbglob; i++) {
+        pack(&out, get_field(col->globs + i, vec), field_width(col->globs + i));
+    }
+    for (uint p = 0; p < col->nbproc; p++) {
+        Intern* t = col->tables[p];
+        uint width = t ? t->width : 1;
+        ull words [width];
+        words[0] = 0;
+        Packer comp = { words, 0, 0 };
+        for (uint i = 0; i < col->nbfield[p]; i++) {
+            Field* f = col->fields[p] + i;
+            pack(&comp, get_field(f, vec), field_width(f));
+        }
+        if (!t) {
+            pack(&out, words[0], col->bits[p]);
+            continue;
+        }
+        if (col->shared) pthread_mutex_lock(&t->lock);
+        uint id = intern(t, words);
+        if (col->shared) pthread_mutex_unlock(&t->lock);
+        pack(&out, id, COLLAPSE_MAX_INLINE);
+    }
+}
+
+ull collapse_components (Collapse* col) {
+    ull nb = 0;
+    for (uint p = 0; p < col->nbproc; p++) {
+        if (col->tables[p]) nb += col->tables[p]->nb;
+    }
+    return nb;
+}
+
+// Components and slots of the tables
+ull collapse_words (Collapse* col) {
+    ull nb = 0;
+    for (uint p = 0; p < col->nbproc; p++) {
+        Intern* t = col->tables[p];
+        if (t) nb += t->nb * t->width + t->capacity * sizeof(uint) / sizeof(ull);
+    }
+    return nb;
+}
+
+WorkList* create_worklist (uint width) {
+    WorkList* queue = malloc(sizeof(WorkList));
+    queue->stride = 2 + width;
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->spare = NULL;
+    return queue;
+}
+
+void free_chunks (Chunk* chunk) {
+    while (chunk) {
+        Chunk* tmp = chunk;
+        chunk = chunk->next;
+        free(tmp);
+    }
+}
+
+void free_worklist (WorkList* todo) {
+    free_chunks(todo->head);
+    free_chunks(todo->spare);
+    free(todo);
+}
+
+void enqueue (WorkList* todo, Compute* item) {
+    Chunk* tail = todo->tail;
+    if (!tail || tail->len == CHUNK_LEN) {
+        Chunk* chunk = todo->spare;
+        if (chunk) {
+            todo->spare = chunk->next;
+        } else {
+            chunk = malloc(sizeof(Chunk) + CHUNK_LEN * todo->stride * sizeof(ull));
+        }
+        chunk->len = 0;
+        chunk->read = 0;
+        chunk->stride = todo->stride;
+        chunk->next = NULL;
+        if (tail) tail->next = chunk; else todo->head = chunk;
+        todo->tail = tail = chunk;
+    }
+    ull* entry = tail->data + tail->len++ * tail->stride;
+    memcpy(entry, &item->diff, sizeof(Diff*));
+    entry[1] = item->hashed;
+    memcpy(entry + 2, item->vec, (tail->stride - 2) * sizeof(ull));
+}
+
+bool dequeue (WorkList* todo, Compute* item) {
+    Chunk* head = todo->head;
+    if (!head) return false;
+    chunk_get(head, head->read++, item);
+    if (head->read == head->len) recycle_chunk(todo, pop_chunk(todo));
+    return true;
+}
+
+Chunk* pop_chunk (WorkList* todo) {
+    Chunk* head = todo->head;
+    if (!head) return NULL;
+    todo->head = head->next;
+    if (!todo->head) todo->tail = NULL;
+    head->next = NULL;
+    return head;
+}
+
+uint chunk_len (Chunk* chunk) {
+    return chunk->len;
+}
+
+void chunk_get (Chunk* chunk, uint i, Compute* item) {
+    ull* entry = chunk->data + i * chunk->stride;
+    memcpy(&item->diff, entry, sizeof(Diff*));
+    item->hashed = entry[1];
+    memcpy(item->vec, entry + 2, (chunk->stride - 2) * sizeof(ull));
+}
+
+void recycle_chunk (WorkList* todo, Chunk* chunk) {
+    chunk->next = todo->spare;
+    todo->spare = chunk;
+}
+
+Frontier* create_frontier (uint width) {
+    Frontier* heap = malloc(sizeof(Frontier));
+    heap->stride = 4 + width;
+    heap->size = 0;
+    heap->capacity = INIT_CAPACITY;
+    heap->seq = 0;
+    heap->data = malloc(heap->capacity * heap->stride * sizeof(ull));
+    return heap;
+}
+
+void free_frontier (Frontier* heap) {
+    free(heap->data);
+    free(heap);
+}
+
+ull frontier_size (Frontier* heap) {
+    return heap->size;
+}
+
+bool entry_before (ull* lhs, ull* rhs) {
+    return lhs[0] < rhs[0] || (lhs[0] == rhs[0] && lhs[1] < rhs[1]);
+}
+
+void swap_entries (Frontier* heap, ull i, ull j) {
+    ull tmp [heap->stride];
+    size_t size = heap->stride * sizeof(ull);
+    memcpy(tmp, heap->data + i * heap->stride, size);
+    memcpy(heap->data + i * heap->stride, heap->data + j * heap->stride, size);
+    memcpy(heap->data + j * heap->stride, tmp, size);
+}
+
+void push_frontier (Frontier* heap, Compute* item, ull prio) {
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        heap->data = realloc(heap->data, heap->capacity * heap->stride * sizeof(ull));
+    }
+    ull i = heap->size++;
+    ull* entry = heap->data + i * heap->stride;
+    entry[0] = prio;
+    entry[1] = heap->seq++;
+    memcpy(entry + 2, &item->diff, sizeof(Diff*));
+    entry[3] = item->hashed;
+    memcpy(entry + 4, item->vec, (heap->stride - 4) * sizeof(ull));
+    // sift up
+    while (i > 0) {
+        ull parent = (i - 1) / 2;
+        if (!entry_before(heap->data + i * heap->stride, heap->data + parent * heap->stride)) break;
+        swap_entries(heap, i, parent);
+        i = parent;
+    }
+}
+
+void get_entry (Frontier* heap, ull i, Compute* item) {
+    ull* entry = heap->data + i * heap->stride;
+    memcpy(&item->diff, entry + 2, sizeof(Diff*));
+    item->hashed = entry[3];
+    memcpy(item->vec, entry + 4, (heap->stride - 4) * sizeof(ull));
+}
+
+void sift_down (Frontier* heap, ull i) {
+    for (;;) {
+        ull best = i;
+        for (ull c = 2 * i + 1; c <= 2 * i + 2 && c < heap->size; c++) {
+            if (entry_before(heap->data + c * heap->stride, heap->data + best * heap->stride)) best = c;
+        }
+        if (best == i) break;
+        swap_entries(heap, i, best);
+        i = best;
+    }
+}
+
+bool pop_frontier (Frontier* heap, Compute* item) {
+    if (!heap->size) return false;
+    get_entry(heap, 0, item);
+    heap->size--;
+    if (!heap->size) return true;
+    memcpy(heap->data, heap->data + heap->size * heap->stride, heap->stride * sizeof(ull));
+    sift_down(heap, 0);
+    return true;
+}
+
+void reorder_frontier (Frontier* heap, ull (*prio) (void* ctx, Compute* item), void* ctx, Compute* item) {
+    for (ull i = 0; i < heap->size; i++) {
+        get_entry(heap, i, item);
+        heap->data[i * heap->stride] = prio(ctx, item);
+    }
+    // rebuild the heap from the bottom up
+    for (ull i = heap->size / 2; i-- > 0;) sift_down(heap, i);
+}
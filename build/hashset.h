@@ -0,0 +1,133 @@
+#ifndef HASHSET_H
+#define HASHSET_H
+
+#include "exec.h"
+#include "prelude.h"
+
+// Print information about hash collisions
+// and hashset load
+#define HASHSET_SHOW_STATS 0
+
+typedef struct HashSet HashSet;
+typedef struct SharedSet SharedSet;
+typedef struct BitState BitState;
+typedef struct Collapse Collapse;
+typedef struct WorkList WorkList;
+typedef struct Chunk Chunk;
+typedef struct Frontier Frontier;
+
+// A Compute is stored in the set as its packed vector (see layout.h)
+uint key_width (RProg* prog);
+
+ull hash (Compute* item);
+ull hash_key (ull* key, uint width);
+bool equals (Compute* lhs, Compute* rhs);
+
+// Incremental hashing: the hash of a state is the sum of the hashes of
+// its fields (variables by id, then processes), so that changing a field
+// only changes one term (see Compute.hashed)
+static inline ull hash_field (uint field, ull val) {
+    ull h = (val + 1) * 0x9e3779b97f4a7c15 ^ ((ull)field + 1) * 0xc2b2ae3d27d4eb4f;
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9;
+    h ^= h >> 29;
+    return h;
+}
+ull hash_fields (RProg* prog, Vec vec);
+
+HashSet* create_hashset (uint width);
+void free_hashset (HashSet* set);
+void insert (HashSet* set, Compute* item, ull hashed);
+bool query (HashSet* set, Compute* item, ull hashed);
+bool try_insert (HashSet* set, Compute* item);
+bool try_insert_key (HashSet* set, ull* key, ull hashed);
+ull hashset_size (HashSet* set);
+
+// Occupation of a set and cost of its lookups, for --stats
+typedef struct {
+    ull nbkey;
+    ull capacity; // slots
+    ull bytes; // memory of the slots
+    ull lookups;
+    ull probes; // occupied slots inspected during lookups
+    ull collisions; // lookups whose first slot holds a different key
+} SetStats;
+// Accumulated into `stats`
+void hashset_stats (HashSet* set, SetStats* stats);
+
+// A set can also map each key to `nbval` words
+HashSet* create_hashmap (uint width, uint nbval);
+// Values of the key, inserted with all values 0 if absent
+// (the pointer is valid until the next insertion)
+ull* get_or_insert (HashSet* map, ull* key, ull hashed, bool* added);
+
+// A set that can be accessed by several threads at once:
+// keys are spread over independent shards, each with its own lock
+// (with a single thread there is one shard and no locking)
+SharedSet* create_sharedset (uint width, uint nbthread);
+void free_sharedset (SharedSet* set);
+bool try_insert_shared (SharedSet* set, ull* key, ull hashed);
+// Number of keys (not to be called while other threads insert)
+ull sharedset_size (SharedSet* set);
+// Accumulated over all shards (same restriction)
+void sharedset_stats (SharedSet* set, SetStats* stats);
+// Call `fn` on every key with its hash (same restriction),
+// which can be inserted again with try_insert_shared
+void sharedset_foreach (SharedSet* set, void (*fn) (void* ctx, ull* key, ull hashed), void* ctx);
+
+// Approximate set (bitstate hashing): a key only sets a few bits of a
+// large array, and is considered present if they are all set already
+// Can be accessed by several threads at once without locking
+BitState* create_bitstate (ull nbbit);
+void free_bitstate (BitState* set);
+bool try_insert_bits (BitState* set, ull hashed);
+// Probability that a new key is wrongly reported as present
+double bitstate_omission (BitState* set);
+// Bits set out of all bits (there are no lookups to count)
+void bitstate_stats (BitState* set, SetStats* stats);
+// The bit array, to be saved, or restored then followed by bitstate_recount
+ull* bitstate_words (BitState* set, ull* nbword);
+void bitstate_recount (BitState* set);
+
+// Collapse compression: the component of each process (its step and
+// its locals) is interned in a table of its own, and the key that is
+// stored is made of the globals followed by one index per process
+// Can be accessed by several threads at once (one lock per table)
+Collapse* create_collapse (RProg* prog, uint nbthread);
+void free_collapse (Collapse* col);
+// Number of words of a collapsed key
+uint collapse_width (Collapse* col);
+// Write the collapsed key of `vec` (interning new components)
+void collapse (Collapse* col, Vec vec, ull* key);
+// Distinct components and the number of words they occupy
+ull collapse_components (Collapse* col);
+ull collapse_words (Collapse* col);
+
+// First in, first out list of states
+// The diff, hash and vector of a Compute are copied into large chunks,
+// which are reused once they have been drained
+WorkList* create_worklist (uint width);
+void free_worklist (WorkList* todo);
+void enqueue (WorkList* todo, Compute* item);
+// Overwrites the diff, hash and vector of `item`, false if empty
+bool dequeue (WorkList* todo, Compute* item);
+
+// Consume a worklist one chunk at a time
+// (chunks can be handed to other threads, then given back to any worklist)
+Chunk* pop_chunk (WorkList* todo);
+uint chunk_len (Chunk* chunk);
+void chunk_get (Chunk* chunk, uint i, Compute* item);
+void recycle_chunk (WorkList* todo, Chunk* chunk);
+
+// States by increasing priority, first in first out among equal ones
+Frontier* create_frontier (uint width);
+void free_frontier (Frontier* heap);
+ull frontier_size (Frontier* heap);
+void push_frontier (Frontier* heap, Compute* item, ull prio);
+// Overwrites the diff, hash and vector of `item`, false if empty
+bool pop_frontier (Frontier* heap, Compute* item);
+// Give every state the priority `prio` computes from it (loaded into `item`),
+// states keep their order among equal priorities
+void reorder_frontier (Frontier* heap, ull (*prio) (void* ctx, Compute* item), void* ctx, Compute* item);
+
+#endif // HASHSET_H
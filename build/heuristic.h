@@ -0,0 +1,29 @@
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+#include "exec.h"
+#include "prelude.h"
+
+// Estimate of how far a state is from satisfying a check, used to
+// explore the most promising states first (see SEARCH_BEST in exec.h)
+//
+// It is the sum of two terms:
+// - how far the variables are from satisfying the condition
+//   (e.g. |x - y| for `x = y`, the sum for `&&`, the minimum for `||`),
+//   for the values of the ranges that come closest
+// - the fewest steps any process needs before it assigns one of the
+//   variables of the condition, in the graph of its steps
+// It is 0 exactly when the condition holds, but it is not a lower
+// bound on the length of a trace
+
+typedef struct Heuristic Heuristic;
+
+// Requires `range_max` to be set (see exec.h)
+Heuristic* create_heuristic (RProg* prog);
+void free_heuristic (Heuristic* heur);
+
+// Smallest estimate over the checks that are not satisfied yet
+// (`sat[k]` is NULL), 0 if there are none, at most 2^32
+ull estimate (Heuristic* heur, Vec vec, Sat* sat);
+
+#endif // HEURISTIC_H
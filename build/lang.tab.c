@@ -0,0 +1,2328 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "src/lang.y"
+
+
+#include "prelude.h"
+#include "ast.h"
+
+int yylex ();
+
+char* fname_src;
+extern int yylineno;
+void yyerror (const char *s) {
+	fflush(stdout);
+	fprintf(stderr, "%s\nat %s:%d", s, fname_src, yylineno);
+}
+
+/***************************************************************************/
+/* All output data available here */
+
+Prog* program;
+
+// Helper variables to assign unique identifiers to variables and statements
+uint unique_var_id;
+uint unique_stmt_id;
+
+// Uses the 'range operator' feature
+bool use_range = false;
+
+
+#line 99 "build/lang.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 1
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    DECL = 258,                    /* DECL  */
+    SEQ = 259,                     /* SEQ  */
+    BRANCH = 260,                  /* BRANCH  */
+    THEN = 261,                    /* THEN  */
+    IF = 262,                      /* IF  */
+    FI = 263,                      /* FI  */
+    DO = 264,                      /* DO  */
+    OD = 265,                      /* OD  */
+    ELSE = 266,                    /* ELSE  */
+    BREAK = 267,                   /* BREAK  */
+    NOT = 268,                     /* NOT  */
+    ASSIGN = 269,                  /* ASSIGN  */
+    PROC = 270,                    /* PROC  */
+    END = 271,                     /* END  */
+    REACH = 272,                   /* REACH  */
+    SKIP = 273,                    /* SKIP  */
+    OPEN = 274,                    /* OPEN  */
+    CLOSE = 275,                   /* CLOSE  */
+    OR = 276,                      /* OR  */
+    AND = 277,                     /* AND  */
+    EQ = 278,                      /* EQ  */
+    ADD = 279,                     /* ADD  */
+    SUB = 280,                     /* SUB  */
+    GT = 281,                      /* GT  */
+    LT = 282,                      /* LT  */
+    GEQ = 283,                     /* GEQ  */
+    LEQ = 284,                     /* LEQ  */
+    DIV = 285,                     /* DIV  */
+    MOD = 286,                     /* MOD  */
+    MUL = 287,                     /* MUL  */
+    RANGE = 288,                   /* RANGE  */
+    IDENT = 289,                   /* IDENT  */
+    INT = 290,                     /* INT  */
+    COMMA = 291                    /* COMMA  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 37 "src/lang.y"
+
+	char* ident;
+    uint digit;
+	Var* var;
+    Proc* proc;
+    Check* check;
+    Stmt* stmt;
+    Expr* expr;
+    Branch* branch;
+
+#line 193 "build/lang.tab.c"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+/* Location type.  */
+#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
+typedef struct YYLTYPE YYLTYPE;
+struct YYLTYPE
+{
+  int first_line;
+  int first_column;
+  int last_line;
+  int last_column;
+};
+# define YYLTYPE_IS_DECLARED 1
+# define YYLTYPE_IS_TRIVIAL 1
+#endif
+
+
+extern YYSTYPE yylval;
+extern YYLTYPE yylloc;
+
+int yyparse (void);
+
+
+
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_DECL = 3,                       /* DECL  */
+  YYSYMBOL_SEQ = 4,                        /* SEQ  */
+  YYSYMBOL_BRANCH = 5,                     /* BRANCH  */
+  YYSYMBOL_THEN = 6,                       /* THEN  */
+  YYSYMBOL_IF = 7,                         /* IF  */
+  YYSYMBOL_FI = 8,                         /* FI  */
+  YYSYMBOL_DO = 9,                         /* DO  */
+  YYSYMBOL_OD = 10,                        /* OD  */
+  YYSYMBOL_ELSE = 11,                      /* ELSE  */
+  YYSYMBOL_BREAK = 12,                     /* BREAK  */
+  YYSYMBOL_NOT = 13,                       /* NOT  */
+  YYSYMBOL_ASSIGN = 14,                    /* ASSIGN  */
+  YYSYMBOL_PROC = 15,                      /* PROC  */
+  YYSYMBOL_END = 16,                       /* END  */
+  YYSYMBOL_REACH = 17,                     /* REACH  */
+  YYSYMBOL_SKIP = 18,                      /* SKIP  */
+  YYSYMBOL_OPEN = 19,                      /* OPEN  */
+  YYSYMBOL_CLOSE = 20,                     /* CLOSE  */
+  YYSYMBOL_OR = 21,                        /* OR  */
+  YYSYMBOL_AND = 22,                       /* AND  */
+  YYSYMBOL_EQ = 23,                        /* EQ  */
+  YYSYMBOL_ADD = 24,                       /* ADD  */
+  YYSYMBOL_SUB = 25,                       /* SUB  */
+  YYSYMBOL_GT = 26,                        /* GT  */
+  YYSYMBOL_LT = 27,                        /* LT  */
+  YYSYMBOL_GEQ = 28,                       /* GEQ  */
+  YYSYMBOL_LEQ = 29,                       /* LEQ  */
+  YYSYMBOL_DIV = 30,                       /* DIV  */
+  YYSYMBOL_MOD = 31,                       /* MOD  */
+  YYSYMBOL_MUL = 32,                       /* MUL  */
+  YYSYMBOL_RANGE = 33,                     /* RANGE  */
+  YYSYMBOL_IDENT = 34,                     /* IDENT  */
+  YYSYMBOL_INT = 35,                       /* INT  */
+  YYSYMBOL_COMMA = 36,                     /* COMMA  */
+  YYSYMBOL_37_ = 37,                       /* '{'  */
+  YYSYMBOL_38_ = 38,                       /* '}'  */
+  YYSYMBOL_YYACCEPT = 39,                  /* $accept  */
+  YYSYMBOL_prog = 40,                      /* prog  */
+  YYSYMBOL_decls = 41,                     /* decls  */
+  YYSYMBOL_vars = 42,                      /* vars  */
+  YYSYMBOL_procs = 43,                     /* procs  */
+  YYSYMBOL_procdef = 44,                   /* procdef  */
+  YYSYMBOL_stmts = 45,                     /* stmts  */
+  YYSYMBOL_stmt = 46,                      /* stmt  */
+  YYSYMBOL_branches = 47,                  /* branches  */
+  YYSYMBOL_branch = 48,                    /* branch  */
+  YYSYMBOL_else = 49,                      /* else  */
+  YYSYMBOL_expr = 50,                      /* expr  */
+  YYSYMBOL_checks = 51                     /* checks  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
+             && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+  YYLTYPE yyls_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
+      + 2 * YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  6
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   177
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  39
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  13
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  42
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  89
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   291
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    37,     2,    38,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_uint8 yyrline[] =
+{
+       0,    79,    79,    86,    87,   113,   114,   115,   118,   119,
+     122,   125,   126,   129,   130,   131,   132,   133,   139,   140,
+     141,   144,   147,   152,   153,   154,   155,   156,   157,   158,
+     159,   160,   161,   162,   163,   164,   165,   166,   169,   170,
+     171,   174,   175
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "DECL", "SEQ",
+  "BRANCH", "THEN", "IF", "FI", "DO", "OD", "ELSE", "BREAK", "NOT",
+  "ASSIGN", "PROC", "END", "REACH", "SKIP", "OPEN", "CLOSE", "OR", "AND",
+  "EQ", "ADD", "SUB", "GT", "LT", "GEQ", "LEQ", "DIV", "MOD", "MUL",
+  "RANGE", "IDENT", "INT", "COMMA", "'{'", "'}'", "$accept", "prog",
+  "decls", "vars", "procs", "procdef", "stmts", "stmt", "branches",
+  "branch", "else", "expr", "checks", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-45)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+       1,   -19,    19,   -10,     6,   -45,   -45,   -14,     4,   -10,
+      21,   -19,     1,    64,    22,   -45,   -19,   -45,     5,    64,
+      64,    64,   -45,   -45,    64,    99,   -45,   -45,    20,    67,
+     -45,   -45,    62,    68,    74,   -45,    26,   -29,   111,    64,
+      64,    64,    64,    64,    64,    64,    64,    64,    64,    64,
+      64,   -45,    60,    60,    64,   -45,     5,   -45,    64,   135,
+     145,    50,   -29,   -29,    50,    50,    50,    50,   -45,   -45,
+     -45,    80,    79,    83,   -45,    38,    82,   124,   -45,    81,
+       5,   -45,    60,     5,   -45,   -45,   -45,   -45,   -45
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       4,     0,     0,     9,     0,     3,     1,     0,    42,     9,
+       5,     0,     4,     0,     0,     8,     0,     6,     0,     0,
+       0,     0,    24,    23,     0,    42,     2,     7,     0,     0,
+      16,    17,     0,     0,    11,    39,     0,    40,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    41,     0,     0,     0,    10,     0,    38,     0,    27,
+      28,    29,    25,    26,    30,    32,    31,    33,    36,    35,
+      34,     0,     0,    18,    19,     0,     0,    13,    12,     0,
+       0,    15,     0,     0,    14,    37,    22,    20,    21
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -45,   -45,    78,     2,    84,   -45,   -40,   -45,   -44,   -45,
+     -45,   -13,    66
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     2,     3,     5,     8,     9,    33,    34,    72,    73,
+      74,    75,    14
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
+{
+      25,    48,    49,    50,     1,     7,    35,    36,    37,    76,
+      10,    38,    28,    17,    29,     4,    78,    30,    27,     6,
+      12,    13,    26,    31,    16,    52,    59,    60,    61,    62,
+      63,    64,    65,    66,    67,    68,    69,    70,    87,    32,
+      86,    77,    11,    88,    83,    79,    57,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    39,
+      40,    41,    42,    43,    44,    45,    46,    47,    48,    49,
+      50,    71,    53,    19,    42,    43,    54,    19,    56,    20,
+      48,    49,    50,    20,    55,    21,    80,    81,    82,    21,
+      18,    51,    84,    15,    22,    23,     0,    24,    22,    23,
+       0,    24,    39,    40,    41,    42,    43,    44,    45,    46,
+      47,    48,    49,    50,     0,     0,    13,     0,     0,    85,
+      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
+      49,    50,    39,    40,    41,    42,    43,    44,    45,    46,
+      47,    48,    49,    50,    58,    39,    40,    41,    42,    43,
+      44,    45,    46,    47,    48,    49,    50,    40,    41,    42,
+      43,    44,    45,    46,    47,    48,    49,    50,    41,    42,
+      43,    44,    45,    46,    47,    48,    49,    50
+};
+
+static const yytype_int8 yycheck[] =
+{
+      13,    30,    31,    32,     3,    15,    19,    20,    21,    53,
+       4,    24,     7,    11,     9,    34,    56,    12,    16,     0,
+      34,    17,     0,    18,     3,     5,    39,    40,    41,    42,
+      43,    44,    45,    46,    47,    48,    49,    50,    82,    34,
+      80,    54,    36,    83,     6,    58,    20,    21,    22,    23,
+      24,    25,    26,    27,    28,    29,    30,    31,    32,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,    30,    31,
+      32,    11,     5,    13,    24,    25,    14,    13,     4,    19,
+      30,    31,    32,    19,    16,    25,     6,     8,     5,    25,
+      12,    25,    10,     9,    34,    35,    -1,    37,    34,    35,
+      -1,    37,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,    -1,    -1,    17,    -1,    -1,    38,
+      21,    22,    23,    24,    25,    26,    27,    28,    29,    30,
+      31,    32,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,    33,    21,    22,    23,    24,    25,
+      26,    27,    28,    29,    30,    31,    32,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     3,    40,    41,    34,    42,     0,    15,    43,    44,
+       4,    36,    34,    17,    51,    43,     3,    42,    41,    13,
+      19,    25,    34,    35,    37,    50,     0,    42,     7,     9,
+      12,    18,    34,    45,    46,    50,    50,    50,    50,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,    30,    31,
+      32,    51,     5,     5,    14,    16,     4,    20,    33,    50,
+      50,    50,    50,    50,    50,    50,    50,    50,    50,    50,
+      50,    11,    47,    48,    49,    50,    47,    50,    45,    50,
+       6,     8,     5,     6,    10,    38,    45,    47,    45
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    39,    40,    41,    41,    42,    42,    42,    43,    43,
+      44,    45,    45,    46,    46,    46,    46,    46,    47,    47,
+      47,    48,    49,    50,    50,    50,    50,    50,    50,    50,
+      50,    50,    50,    50,    50,    50,    50,    50,    50,    50,
+      50,    51,    51
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     4,     2,     0,     2,     3,     4,     2,     0,
+       5,     1,     3,     3,     4,     4,     1,     1,     1,     1,
+       3,     3,     3,     1,     1,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     5,     3,     2,
+       2,     3,     0
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+#ifndef YYLLOC_DEFAULT
+# define YYLLOC_DEFAULT(Current, Rhs, N)                                \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;        \
+          (Current).first_column = YYRHSLOC (Rhs, 1).first_column;      \
+          (Current).last_line    = YYRHSLOC (Rhs, N).last_line;         \
+          (Current).last_column  = YYRHSLOC (Rhs, N).last_column;       \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).first_line   = (Current).last_line   =              \
+            YYRHSLOC (Rhs, 0).last_line;                                \
+          (Current).first_column = (Current).last_column =              \
+            YYRHSLOC (Rhs, 0).last_column;                              \
+        }                                                               \
+    while (0)
+#endif
+
+#define YYRHSLOC(Rhs, K) ((Rhs)[K])
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+/* YYLOCATION_PRINT -- Print the location on the stream.
+   This macro was not mandated originally: define only if we know
+   we won't break user code: when these are the locations we know.  */
+
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+
+/* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
+
+YY_ATTRIBUTE_UNUSED
+static int
+yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
+{
+  int res = 0;
+  int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
+  if (0 <= yylocp->first_line)
+    {
+      res += YYFPRINTF (yyo, "%d", yylocp->first_line);
+      if (0 <= yylocp->first_column)
+        res += YYFPRINTF (yyo, ".%d", yylocp->first_column);
+    }
+  if (0 <= yylocp->last_line)
+    {
+      if (yylocp->first_line < yylocp->last_line)
+        {
+          res += YYFPRINTF (yyo, "-%d", yylocp->last_line);
+          if (0 <= end_col)
+            res += YYFPRINTF (yyo, ".%d", end_col);
+        }
+      else if (0 <= end_col && yylocp->first_column < end_col)
+        res += YYFPRINTF (yyo, "-%d", end_col);
+    }
+  return res;
+}
+
+#   define YYLOCATION_PRINT  yy_location_print_
+
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, Location); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]));
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
+/* Return the length of YYSTR.  */
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
+{
+  YYPTRDIFF_T yylen;
+  for (yylen = 0; yystr[yylen]; yylen++)
+    continue;
+  return yylen;
+}
+# endif
+#endif
+
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
+/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
+   YYDEST.  */
+static char *
+yystpcpy (char *yydest, const char *yysrc)
+{
+  char *yyd = yydest;
+  const char *yys = yysrc;
+
+  while ((*yyd++ = *yys++) != '\0')
+    continue;
+
+  return yyd - 1;
+}
+# endif
+#endif
+
+#ifndef yytnamerr
+/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
+   quotes and backslashes, so that it's suitable for yyerror.  The
+   heuristic is that double-quoting is unnecessary unless the string
+   contains an apostrophe, a comma, or backslash (other than
+   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
+   null, do not copy; instead, return the length of what the result
+   would have been.  */
+static YYPTRDIFF_T
+yytnamerr (char *yyres, const char *yystr)
+{
+  if (*yystr == '"')
+    {
+      YYPTRDIFF_T yyn = 0;
+      char const *yyp = yystr;
+      for (;;)
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
+    do_not_strip_quotes: ;
+    }
+
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
+    return yystrlen (yystr);
+}
+#endif
+
+
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
+
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
+
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
+}
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
+{
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Location data for the lookahead symbol.  */
+YYLTYPE yylloc
+# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+  = { 1, 1, 1, 1 }
+# endif
+;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+    /* The location stack: array, bottom, top.  */
+    YYLTYPE yylsa[YYINITDEPTH];
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+  YYLTYPE yyloc;
+
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
+  /* Buffer for error messages, and its allocated size.  */
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  yylsp[0] = yylloc;
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+        YYLTYPE *yyls1 = yyls;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+        yyls = yyls1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        YYSTACK_RELOCATE (yyls_alloc, yyls);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+      yylsp = yyls + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+  *++yylsp = yylloc;
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+  /* Default location. */
+  YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
+  yyerror_range[1] = yyloc;
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* prog: decls procs checks $end  */
+#line 79 "src/lang.y"
+                                {
+        program = make_prog((yyvsp[-3].var), (yyvsp[-2].proc), (yyvsp[-1].check));
+        program->nbvar = unique_var_id;
+        program->nbstmt = unique_stmt_id;
+     }
+#line 1695 "build/lang.tab.c"
+    break;
+
+  case 3: /* decls: DECL vars  */
+#line 86 "src/lang.y"
+                  { (yyval.var) = (yyvsp[0].var); }
+#line 1701 "build/lang.tab.c"
+    break;
+
+  case 4: /* decls: %empty  */
+#line 87 "src/lang.y"
+        { (yyval.var) = NULL; }
+#line 1707 "build/lang.tab.c"
+    break;
+
+  case 5: /* vars: IDENT SEQ  */
+#line 113 "src/lang.y"
+                 { (yyval.var) = make_ident((yyvsp[-1].ident), unique_var_id++); }
+#line 1713 "build/lang.tab.c"
+    break;
+
+  case 6: /* vars: IDENT COMMA vars  */
+#line 114 "src/lang.y"
+                        { ((yyval.var) = make_ident((yyvsp[-2].ident), unique_var_id++))->next = (yyvsp[0].var); }
+#line 1719 "build/lang.tab.c"
+    break;
+
+  case 7: /* vars: IDENT SEQ DECL vars  */
+#line 115 "src/lang.y"
+                           { ((yyval.var) = make_ident((yyvsp[-3].ident), unique_var_id++))->next = (yyvsp[0].var); }
+#line 1725 "build/lang.tab.c"
+    break;
+
+  case 8: /* procs: procdef procs  */
+#line 118 "src/lang.y"
+                      { ((yyval.proc) = (yyvsp[-1].proc))->next = (yyvsp[0].proc); }
+#line 1731 "build/lang.tab.c"
+    break;
+
+  case 9: /* procs: %empty  */
+#line 119 "src/lang.y"
+        { (yyval.proc) = NULL; }
+#line 1737 "build/lang.tab.c"
+    break;
+
+  case 10: /* procdef: PROC IDENT decls stmts END  */
+#line 122 "src/lang.y"
+                                     { (yyval.proc) = make_proc((yyvsp[-3].ident), (yyvsp[-2].var), (yyvsp[-1].stmt)); }
+#line 1743 "build/lang.tab.c"
+    break;
+
+  case 11: /* stmts: stmt  */
+#line 125 "src/lang.y"
+             { (yyval.stmt) = (yyvsp[0].stmt); }
+#line 1749 "build/lang.tab.c"
+    break;
+
+  case 12: /* stmts: stmt SEQ stmts  */
+#line 126 "src/lang.y"
+                       { ((yyval.stmt) = (yyvsp[-2].stmt))->next = (yyvsp[0].stmt); }
+#line 1755 "build/lang.tab.c"
+    break;
+
+  case 13: /* stmt: IDENT ASSIGN expr  */
+#line 129 "src/lang.y"
+                         { ((yyval.stmt) = make_stmt(S_ASSIGN, unique_stmt_id++))->val.assign = make_assign((yyvsp[-2].ident), (yyvsp[0].expr)); }
+#line 1761 "build/lang.tab.c"
+    break;
+
+  case 14: /* stmt: DO BRANCH branches OD  */
+#line 130 "src/lang.y"
+                             { ((yyval.stmt) = make_stmt(S_DO, unique_stmt_id++))->val.branch = (yyvsp[-1].branch); }
+#line 1767 "build/lang.tab.c"
+    break;
+
+  case 15: /* stmt: IF BRANCH branches FI  */
+#line 131 "src/lang.y"
+                             { ((yyval.stmt) = make_stmt(S_IF, unique_stmt_id++))->val.branch = (yyvsp[-1].branch); }
+#line 1773 "build/lang.tab.c"
+    break;
+
+  case 16: /* stmt: BREAK  */
+#line 132 "src/lang.y"
+             { ((yyval.stmt) = make_stmt(S_BREAK, unique_stmt_id++))->val._ = 0; }
+#line 1779 "build/lang.tab.c"
+    break;
+
+  case 17: /* stmt: SKIP  */
+#line 133 "src/lang.y"
+            { ((yyval.stmt) = make_stmt(S_SKIP, unique_stmt_id++))->val._ = 0; }
+#line 1785 "build/lang.tab.c"
+    break;
+
+  case 18: /* branches: branch  */
+#line 139 "src/lang.y"
+                  { (yyval.branch) = (yyvsp[0].branch); }
+#line 1791 "build/lang.tab.c"
+    break;
+
+  case 19: /* branches: else  */
+#line 140 "src/lang.y"
+                { (yyval.branch) = (yyvsp[0].branch); }
+#line 1797 "build/lang.tab.c"
+    break;
+
+  case 20: /* branches: branch BRANCH branches  */
+#line 141 "src/lang.y"
+                                  { ((yyval.branch) = (yyvsp[-2].branch))->next = (yyvsp[0].branch); }
+#line 1803 "build/lang.tab.c"
+    break;
+
+  case 21: /* branch: expr THEN stmts  */
+#line 144 "src/lang.y"
+                         { (yyval.branch) = make_branch((yyvsp[-2].expr), (yyvsp[0].stmt)); }
+#line 1809 "build/lang.tab.c"
+    break;
+
+  case 22: /* else: ELSE THEN stmts  */
+#line 147 "src/lang.y"
+                       { (yyval.branch) = make_branch(NULL, (yyvsp[0].stmt)); }
+#line 1815 "build/lang.tab.c"
+    break;
+
+  case 23: /* expr: INT  */
+#line 152 "src/lang.y"
+           { ((yyval.expr) = make_expr(E_VAL))->val.digit = (yyvsp[0].digit); }
+#line 1821 "build/lang.tab.c"
+    break;
+
+  case 24: /* expr: IDENT  */
+#line 153 "src/lang.y"
+             { ((yyval.expr) = make_expr(E_VAR))->val.ident = (yyvsp[0].ident); }
+#line 1827 "build/lang.tab.c"
+    break;
+
+  case 25: /* expr: expr ADD expr  */
+#line 154 "src/lang.y"
+                     { ((yyval.expr) = make_expr(E_ADD))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1833 "build/lang.tab.c"
+    break;
+
+  case 26: /* expr: expr SUB expr  */
+#line 155 "src/lang.y"
+                     { ((yyval.expr) = make_expr(E_SUB))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1839 "build/lang.tab.c"
+    break;
+
+  case 27: /* expr: expr OR expr  */
+#line 156 "src/lang.y"
+                    { ((yyval.expr) = make_expr(E_OR))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1845 "build/lang.tab.c"
+    break;
+
+  case 28: /* expr: expr AND expr  */
+#line 157 "src/lang.y"
+                     { ((yyval.expr) = make_expr(E_AND))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1851 "build/lang.tab.c"
+    break;
+
+  case 29: /* expr: expr EQ expr  */
+#line 158 "src/lang.y"
+                    { ((yyval.expr) = make_expr(E_EQ))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1857 "build/lang.tab.c"
+    break;
+
+  case 30: /* expr: expr GT expr  */
+#line 159 "src/lang.y"
+                    { ((yyval.expr) = make_expr(E_GT))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1863 "build/lang.tab.c"
+    break;
+
+  case 31: /* expr: expr GEQ expr  */
+#line 160 "src/lang.y"
+                     { ((yyval.expr) = make_expr(E_GEQ))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1869 "build/lang.tab.c"
+    break;
+
+  case 32: /* expr: expr LT expr  */
+#line 161 "src/lang.y"
+                    { ((yyval.expr) = make_expr(E_LT))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1875 "build/lang.tab.c"
+    break;
+
+  case 33: /* expr: expr LEQ expr  */
+#line 162 "src/lang.y"
+                     { ((yyval.expr) = make_expr(E_LEQ))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1881 "build/lang.tab.c"
+    break;
+
+  case 34: /* expr: expr MUL expr  */
+#line 163 "src/lang.y"
+                     { ((yyval.expr) = make_expr(E_MUL))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1887 "build/lang.tab.c"
+    break;
+
+  case 35: /* expr: expr MOD expr  */
+#line 164 "src/lang.y"
+                     { ((yyval.expr) = make_expr(E_MOD))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1893 "build/lang.tab.c"
+    break;
+
+  case 36: /* expr: expr DIV expr  */
+#line 165 "src/lang.y"
+                     { ((yyval.expr) = make_expr(E_DIV))->val.binop = make_binop((yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1899 "build/lang.tab.c"
+    break;
+
+  case 37: /* expr: '{' expr RANGE expr '}'  */
+#line 166 "src/lang.y"
+                               {
+        use_range = true;
+        ((yyval.expr) = make_expr(E_RANGE))->val.binop = make_binop((yyvsp[-3].expr), (yyvsp[-1].expr)); }
+#line 1907 "build/lang.tab.c"
+    break;
+
+  case 38: /* expr: OPEN expr CLOSE  */
+#line 169 "src/lang.y"
+                       { (yyval.expr) = (yyvsp[-1].expr); }
+#line 1913 "build/lang.tab.c"
+    break;
+
+  case 39: /* expr: NOT expr  */
+#line 170 "src/lang.y"
+                { ((yyval.expr) = make_expr(E_NOT))->val.subexpr = (yyvsp[0].expr); }
+#line 1919 "build/lang.tab.c"
+    break;
+
+  case 40: /* expr: SUB expr  */
+#line 171 "src/lang.y"
+                { ((yyval.expr) = make_expr(E_NEG))->val.subexpr = (yyvsp[0].expr); }
+#line 1925 "build/lang.tab.c"
+    break;
+
+  case 41: /* checks: REACH expr checks  */
+#line 174 "src/lang.y"
+                           { ((yyval.check) = make_check((yyvsp[-1].expr)))->next = (yyvsp[0].check); }
+#line 1931 "build/lang.tab.c"
+    break;
+
+  case 42: /* checks: %empty  */
+#line 175 "src/lang.y"
+         { (yyval.check) = NULL; }
+#line 1937 "build/lang.tab.c"
+    break;
+
+
+#line 1941 "build/lang.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+  *++yylsp = yyloc;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
+      }
+    }
+
+  yyerror_range[1] = yylloc;
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, &yylloc);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+      yyerror_range[1] = *yylsp;
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  yyerror_range[2] = yylloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, &yylloc);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+  if (yymsg != yymsgbuf)
+    YYSTACK_FREE (yymsg);
+  return yyresult;
+}
+
+#line 178 "src/lang.y"
+
+
+#include "lex.yy.c"
+#include "argparse.h"
+#include "printer.h"
+#include "exec.h"
+#include "repr.h"
+#include <limits.h>
+
+enum { OK, ARGPARSE_ERROR, SYNTAX_ERROR, SEMANTIC_ERROR, EXTERNAL_ERROR };
+
+// Successors of a step are listed on the stack, keep --range-max reasonable
+const uint RANGE_MAX_LIMIT = 1 << 16;
+
+// `--target` is a comma-separated list of checks, numbered from 1
+// Returns false if it is invalid
+bool parse_targets (char* list, uint nbcheck, bool* targets) {
+    memset(targets, false, nbcheck * sizeof(bool));
+    char* end;
+    for (char* c = list; *c; c = (*end == ',') ? end + 1 : end) {
+        ull k = strtoull(c, &end, 10);
+        if (end == c || (*end && *end != ',') || k == 0 || k > nbcheck) {
+            fprintf(stderr, "Warning: --target '%s' does not name checks from 1 to %u, ignored\n",
+                list, nbcheck);
+            return false;
+        }
+        targets[k-1] = true;
+    }
+    return true;
+}
+
+int main (int argc, char **argv) {
+    Args* args = parse_args(argc, argv);
+    if (!args) exit(ARGPARSE_ERROR);
+	if (!(yyin = fopen(args->fname_src, "r"))) {
+        fprintf(stderr, "File not found '%s'\n", args->fname_src);
+        show_help(false);
+        free(args);
+        exit(ARGPARSE_ERROR);
+    }
+    fname_src = args->fname_src;
+    unique_var_id = 0;
+    unique_stmt_id = 0;
+	if (!yyparse()) {
+        if (args->flags&SHOW_AST) pp_ast(stdout, !(args->flags&NO_COLOR), program);
+        RProg* repr = tr_prog(program, !(args->flags&NO_SIMPLIFY));
+        free_ast();
+        fclose(yyin);
+        yylex_destroy();
+        // last use of `program
+        if (!repr) {
+            // translation failed, cleanup
+            free_repr();
+            free_var();
+            free_ident();
+            free(args);
+            exit(SEMANTIC_ERROR); 
+        }
+        if (args->flags&SHOW_REPR) pp_repr(stdout, !(args->flags&NO_COLOR), repr);
+        if (args->flags&SHOW_DOT) make_dot(args->fname_src, repr);
+        if (args->flags&EXEC_RAND) {
+            RandOpts opts;
+            opts.threads = (uint)get_param(args, THREADS, 1);
+            // a different run every time unless a seed is given
+            opts.seed = get_param(args, SEED, (ull)getpid());
+            opts.adaptive = args->flags&ADAPTIVE;
+            opts.swarm = args->flags&SWARM;
+            opts.time_budget = get_param(args, TIME_BUDGET, 0);
+            // with another stopping criterion walks are not limited by default
+            bool bounded = !opts.adaptive && !opts.time_budget;
+            opts.walks = (uint)get_param(args, WALKS, bounded ? 100 : UINT_MAX);
+            opts.depth = (uint)get_param(args, DEPTH, 100);
+            RandStats stats;
+            Sat* sat = exec_prog_random(repr, &opts, &stats);
+            if (args->flags&SHOW_STATS) pp_rand_stats(&opts, &stats, !(args->flags&NO_COLOR));
+            pp_sat(repr, sat, !(args->flags&NO_COLOR), args->flags&SHOW_TRACE, false);
+            free_sat();
+            // `sat` does not exit this scope
+        }
+        if (args->flags&EXEC_ALL) {
+            ExecOpts opts;
+            opts.search = (Search)get_choice(args, SEARCH, SEARCH_BFS);
+            bool depth_first = opts.search == SEARCH_DFS || opts.search == SEARCH_IDDFS;
+            opts.threads = (opts.search == SEARCH_BFS) ? (uint)get_param(args, THREADS, 1) : 1;
+            opts.por = !depth_first && (args->flags&PARTIAL_ORDER);
+            opts.symmetry = args->flags&SYMMETRY;
+            opts.compact = !depth_first && (args->flags&COMPACT);
+            opts.external_dir = args->params[EXTERNAL_DIR];
+            opts.external_mem = get_param(args, EXTERNAL_MEM, 256) << 20;
+            // iterative deepening needs the depth of each state
+            opts.bitstate = (opts.search == SEARCH_IDDFS) ? 0 : get_param(args, BITSTATE, 0) << 23;
+            opts.collapse = (args->flags&COLLAPSE) && !opts.bitstate;
+            opts.full = args->flags&FULL;
+            opts.range_max = (uint)get_param(args, RANGE_MAX, 1024);
+            if (opts.range_max == 0 || opts.range_max > RANGE_MAX_LIMIT) {
+                fprintf(stderr, "Warning: --range-max must be from 1 to %u, using %u\n",
+                    RANGE_MAX_LIMIT, opts.range_max ? RANGE_MAX_LIMIT : 1);
+                opts.range_max = opts.range_max ? RANGE_MAX_LIMIT : 1;
+            }
+            opts.progress = (uint)get_param(args, PROGRESS, 0);
+            opts.profile = args->flags&PROFILE;
+            // only the breadth-first search in memory takes checkpoints,
+            // a resumed run goes on saving to the same file
+            bool checkpoints = opts.search == SEARCH_BFS && !opts.collapse && !opts.external_dir;
+            opts.resume = checkpoints ? args->params[RESUME] : NULL;
+            opts.checkpoint = args->params[CHECKPOINT] ? args->params[CHECKPOINT] : opts.resume;
+            if (!checkpoints) opts.checkpoint = NULL;
+            opts.checkpoint_every = get_param(args, CHECKPOINT_EVERY, 300);
+            bool targets [repr->nbcheck + 1];
+            opts.targets = NULL;
+            if (args->params[TARGET] && parse_targets(args->params[TARGET], repr->nbcheck, targets)) {
+                opts.targets = targets;
+            }
+            ExecStats stats;
+            Sat* sat = exec_prog_all(repr, &opts, &stats);
+            if (!sat) {
+                // external exploration or resuming failed, cleanup
+                free_sat();
+                free_var();
+                free_repr();
+                free(args);
+                free_ident();
+                exit(EXTERNAL_ERROR);
+            }
+            if (args->flags&SHOW_STATS) {
+                pp_stats(&opts, &stats, !(args->flags&NO_COLOR));
+                pp_found(repr, sat, &stats, !(args->flags&NO_COLOR));
+            }
+            if (opts.symmetry) pp_symmetry(&stats, !(args->flags&NO_COLOR));
+            if (opts.bitstate) pp_bitstate(&stats, !(args->flags&NO_COLOR));
+            if (opts.collapse && !opts.external_dir) pp_collapse(&stats, !(args->flags&NO_COLOR));
+            if (stats.truncated) pp_truncated(&opts, !(args->flags&NO_COLOR));
+            if (stats.profile) {
+                pp_profile(repr, stats.profile, !(args->flags&NO_COLOR));
+                free_profile(stats.profile);
+            }
+            // with bitstate hashing, an early stop or truncated ranges
+            // some states may have been missed
+            pp_sat(repr, sat, !(args->flags&NO_COLOR), args->flags&SHOW_TRACE,
+                !opts.bitstate && !stats.stopped && !stats.truncated);
+            free_sat();
+            // `sat` does not exit this scope
+        }
+        free_var();
+        free_repr();
+        free(args);
+        free_ident();
+        // last use of `repr`
+    } else {
+        // parsing failed, cleanup ast anyway
+        fclose(yyin);
+        yylex_destroy();
+        free_ast();
+        free_var();
+        free(args);
+        free_ident();
+        exit(SYNTAX_ERROR);
+    }
+}
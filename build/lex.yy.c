@@ -0,0 +1,53 @@
+// stand-in for the flex scanner (flex unavailable in sandbox)
+#include "memreg.h"
+#include <ctype.h>
+#include <unistd.h>
+#include <string.h>
+Arena* ident_arena = NULL;
+void free_ident () { arena_free(&ident_arena); }
+FILE* yyin = NULL;
+int yylineno = 1;
+int yylex_destroy (void) { yylineno = 1; return 0; }
+static int next_c (void) { int c = fgetc(yyin); if (c == '\n') yylineno++; return c; }
+static void back_c (int c) { if (c == EOF) return; if (c == '\n') yylineno--; ungetc(c, yyin); }
+int yylex (void) {
+    static const struct { const char* s; int t; } kw [] = {
+        {"var",DECL},{"if",IF},{"fi",FI},{"do",DO},{"od",OD},{"else",ELSE},{"break",BREAK},
+        {"proc",PROC},{"end",END},{"reach",REACH},{"skip",SKIP},
+    };
+    static const struct { const char* s; int t; } ops [] = {
+        {"::",BRANCH},{"->",THEN},{"||",OR},{"&&",AND},{":=",ASSIGN},{"==",EQ},{"<=",LEQ},{">=",GEQ},{"..",RANGE},
+        {",",COMMA},{";",SEQ},{"!",NOT},{"+",ADD},{"-",SUB},{"*",MUL},{">",GT},{"<",LT},{"%",MOD},{"/",DIV},{"(",OPEN},{")",CLOSE},
+    };
+    for (;;) {
+        int c = next_c();
+        if (c == EOF) return 0;
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') continue;
+        if (c == '/') {
+            int d = next_c();
+            if (d == '/') { while ((c = next_c()) != '\n' && c != EOF); continue; }
+            back_c(d); return DIV;
+        }
+        if (isdigit(c)) {
+            uint v = 0;
+            while (isdigit(c)) { v = v*10 + (uint)(c-'0'); c = next_c(); }
+            back_c(c); yylval.digit = v; return INT;
+        }
+        if (islower(c) || c == '_') {
+            char buf [256]; size_t n = 0;
+            while (islower(c) || c == '_' || isdigit(c)) { if (n < 255) buf[n++] = (char)c; c = next_c(); }
+            back_c(c); buf[n] = 0;
+            for (size_t i = 0; i < sizeof(kw)/sizeof(kw[0]); i++) if (!strcmp(buf, kw[i].s)) return kw[i].t;
+            yylval.ident = arena_strdup(&ident_arena, buf); return IDENT;
+        }
+        int d = next_c();
+        for (size_t i = 0; i < sizeof(ops)/sizeof(ops[0]); i++) {
+            if (ops[i].s[1] && ops[i].s[0] == c && ops[i].s[1] == d) return ops[i].t;
+        }
+        back_c(d);
+        for (size_t i = 0; i < sizeof(ops)/sizeof(ops[0]); i++) {
+            if (!ops[i].s[1] && ops[i].s[0] == c) return ops[i].t;
+        }
+        return c;
+    }
+}
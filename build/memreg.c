@@ -0,0 +1,79 @@
+#include "memreg.h"
+#include "prelude.h"
+
+// Usual size of a slab, larger requests get a slab of their own
+const size_t SLAB_SIZE = 1 << 16;
+const size_t ALIGN = 16;
+
+typedef struct Arena {
+    size_t used;
+    size_t capacity;
+    struct Arena* next; // older slabs
+    char* data; // follows the header
+} Arena;
+
+const size_t HEADER = (sizeof(Arena) + 15) & ~(size_t)15;
+
+Arena* new_slab (size_t capacity, Arena* next) {
+    Arena* slab = malloc(HEADER + capacity);
+    slab->used = 0;
+    slab->capacity = capacity;
+    slab->next = next;
+    slab->data = (char*)slab + HEADER;
+    return slab;
+}
+
+void* arena_alloc (Arena** arena, size_t size) {
+    size = (size + ALIGN - 1) & ~(ALIGN - 1);
+    Arena* slab = *arena;
+    if (!slab || slab->used + size > slab->capacity) {
+        if (size > SLAB_SIZE / 4) {
+            // dedicated slab, inserted behind the current one
+            // so that the room left in it is not wasted
+            Arena* big = new_slab(size, slab ? slab->next : NULL);
+            if (slab) slab->next = big; else *arena = big;
+            big->used = size;
+            return big->data;
+        }
+        slab = *arena = new_slab(SLAB_SIZE, slab);
+    }
+    void* ptr = slab->data + slab->used;
+    slab->used += size;
+    return ptr;
+}
+
+char* arena_strdup (Arena** arena, const char* str) {
+    size_t len = strlen(str) + 1;
+    char* cpy = arena_alloc(arena, len);
+    memcpy(cpy, str, len);
+    return cpy;
+}
+
+void arena_free (Arena** arena) {
+#if MEMREG_SHOW_STATS
+    uint nbslabs = 0;
+    size_t nbbytes = 0;
+#endif // MEMREG_SHOW_STATS
+    while (*arena) {
+        Arena* tmp = *arena;
+        *arena = tmp->next;
+#if MEMREG_SHOW_STATS
+        nbslabs++;
+        nbbytes += tmp->used;
+#endif // MEMREG_SHOW_STATS
+        free(tmp);
+    }
+#if MEMREG_SHOW_STATS
+    printf("-> %d slabs deallocated from %p\n", nbslabs, (void*)arena);
+    printf("   total %zu bytes used\n", nbbytes);
+#endif // MEMREG_SHOW_STATS
+}
+
+void arena_merge (Arena** into, Arena** from) {
+    if (!*from) return;
+    Arena* last = *from;
+    while (last->next) last = last->next;
+    last->next = *into;
+    *into = *from;
+    *from = NULL;
+}
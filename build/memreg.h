@@ -0,0 +1,34 @@
+#ifndef MEMREG_H
+#define MEMREG_H
+
+#include <stddef.h>
+
+#define MEMREG_SHOW_STATS 0
+
+// Any file/function/procedure that wishes to make many memory
+// allocations without freeing them at the end of the procedure
+// (i.e. parsing, the ast -> repr conversion, trace diffs) may use an
+// Arena* variable to allocate from and perform a batch free
+// at a later time.
+//
+// Allocation bumps a pointer inside a large slab, freeing releases
+// the slabs all at once. Individual allocations cannot be freed.
+typedef struct Arena Arena;
+
+// Memory for `size` bytes, suitably aligned for any type
+void* arena_alloc (Arena** arena, size_t size);
+
+// Copy of a string
+char* arena_strdup (Arena** arena, const char* str);
+
+// Release everything allocated from `arena`
+void arena_free (Arena** arena);
+
+// Move all slabs of `from` to `into`
+// (for arenas filled by different threads)
+void arena_merge (Arena** into, Arena** from);
+
+#define ARENA_NEW(arena, T) ((T*)arena_alloc((arena), sizeof(T)))
+#define ARENA_ARRAY(arena, T, n) ((T*)arena_alloc((arena), (size_t)(n) * sizeof(T)))
+
+#endif // MEMREG_H
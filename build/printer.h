@@ -0,0 +1,38 @@
+#ifndef PRINTER_H
+#define PRINTER_H
+
+#include "ast.h"
+#include "repr.h"
+#include "exec.h"
+#include "profile.h"
+
+// Pretty-print parsed ast
+// (i.e. "Niveau 1")
+void pp_ast (FILE* f, bool color, Prog* prog);
+
+// Pretty-print internal representation
+void pp_repr (FILE* f, bool color, RProg* prog);
+
+// Dot-readable format 
+void pp_dot (FILE* fdest, RProg* prog); // dump
+void make_dot (char* fname_src, RProg* prog); // render
+
+// Reachability trace
+void pp_sat (RProg* prog, Sat* sat, bool color, bool trace, bool exhaustive);
+
+// Size of the exhaustive exploration
+void pp_stats (ExecOpts* opts, ExecStats* stats, bool color);
+// When each satisfied check was found
+void pp_found (RProg* prog, Sat* sat, ExecStats* stats, bool color);
+void pp_rand_stats (RandOpts* opts, RandStats* stats, bool color);
+
+// Effect of symmetry reduction
+void pp_symmetry (ExecStats* stats, bool color);
+void pp_bitstate (ExecStats* stats, bool color);
+void pp_collapse (ExecStats* stats, bool color);
+// Some values of a range were beyond --range-max
+void pp_truncated (ExecOpts* opts, bool color);
+// Counters of each step and guard (see profile.h)
+void pp_profile (RProg* prog, Profile* prof, bool color);
+
+#endif // PRINTER_H
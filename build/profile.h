@@ -0,0 +1,45 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "exec.h"
+#include "prelude.h"
+
+// Counters of the exhaustive exploration for each step and each guard,
+// to see which parts of a program it spends its time on (--profile)
+//
+// A step is evaluated every time a state where a process is at this
+// step is expanded, and enabled when it has at least one transition.
+// Each of its guards is then evaluated, and enabled when it holds.
+// The transitions of a step are credited to the guard they go through,
+// if any, and to the step, as new or seen depending on the state they
+// lead to.
+// Steps fused with --compact are not counted.
+
+typedef enum {
+    PROF_EVAL,
+    PROF_ENABLED,
+    PROF_DIVZERO, // blocked by a division by zero
+    PROF_NEW,
+    PROF_SEEN,
+    NB_PROF,
+} ProfCounter;
+
+typedef struct Profile Profile;
+
+// Each thread of the exploration has its own
+Profile* create_profile (RProg* prog);
+void free_profile (Profile* prof);
+// Add the counters of `other` to those of `prof`
+void merge_profile (Profile* prof, Profile* other);
+
+// `step` of a process was expanded from `vec`, with `nbnext` transitions
+// (`buf` is the one of the thread, its successors are left untouched)
+void profile_step (Profile* prof, EvalBuf* buf, RStep* step, Vec vec, uint nbnext);
+// The transition `next` of `step` led to a state that was `fresh` or not
+void profile_next (Profile* prof, RStep* step, Succ* next, bool fresh);
+
+// NB_PROF counters of a step, or of its guard `i`
+ull* step_counters (Profile* prof, RStep* step);
+ull* guard_counters (Profile* prof, RStep* step, uint i);
+
+#endif // PROFILE_H
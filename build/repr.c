@@ -0,0 +1,300 @@
+#include "repr.h"
+#include "layout.h"
+#include "reduce.h"
+#include "bytecode.h"
+#include "simplify.h"
+#include "memreg.h"
+
+Arena* repr_arena = NULL;
+void* alloc_repr (size_t size) { return arena_alloc(&repr_arena, size); }
+void free_repr () { arena_free(&repr_arena); }
+
+uint tr_var_list (Var** loc, Var* in);
+uint tr_check_list (RCheck** loc, Check* in);
+RExpr* tr_expr (Expr* in);
+Var* locate_var (char* ident);
+uint tr_proc_list (RProc** loc, Proc* in);
+
+void tr_stmt (
+    RStep** out, Stmt* in,
+    bool advance, RStep* skipto, RStep* breakto);
+
+RStep* tr_branch_list (
+    uint* nb, RGuard** loc, Branch* in,
+    bool advance, RStep* skipto, RStep* breakto);
+
+bool failed; // exit the translation if something went wrong
+
+// Translate from ast to repr
+// Ast is fine for parsing and for display, but it is poorly suited
+// for execution.
+// Linked lists everywhere are unefficient, branches are not connected
+// to their continuation
+// The internal representation solves this issue by making each statement
+// a node in a directed graph.
+// Each node has an optional assignment, zero or more guarded continuations,
+// zero or one unguarded continuations. The continuations are simply
+// pointers to the corresponding nodes.
+// The main difficulty is to link the endings of branches in if and do
+// to their continuation. This is done with a skipto/breakto mechanism,
+// explained in more detail below.
+
+uint nbglob;
+uint nbloc;
+Var* globs;
+Var* locs;
+char* procname;
+
+RProg* tr_prog (Prog* in, bool simplify) {
+    failed = false;
+    RProg* out = alloc_repr(sizeof(RProg));
+    out->nbstep = in->nbstmt;
+    out->nbvar = in->nbvar;
+    // Write global variables
+    out->nbglob = tr_var_list(&out->globs, in->globs);
+    nbglob = out->nbglob;
+    globs = out->globs;
+    out->nbproc = tr_proc_list(&out->procs, in->procs);
+    out->nbcheck = tr_check_list(&out->checks, in->checks);
+    if (failed) {
+        return NULL; // out is still registered for free
+    } else {
+        out->nbfold = 0;
+        out->nbprune = 0;
+        if (simplify) simplify_prog(out);
+        out->layout = make_layout(out);
+        find_local_steps(out);
+        out->symmetry = make_symmetry(out);
+        compile_prog(out);
+        return out;
+    }
+}
+
+// List to array conversion
+uint tr_var_list (Var** loc, Var* in) {
+    {
+        uint len = 0;
+        Var* cur = in;
+        while (cur) { len++; cur = cur->next; }
+        *loc = alloc_repr(len * sizeof(Var));
+    }
+    uint n = 0;
+    Var* cur = in;
+    while (cur) {
+        (*loc)[n].name = cur->name;
+        (*loc)[n].id = cur->id;
+        n++;
+        cur = cur->next;
+    }
+    return n;
+}
+
+uint tr_check_list (RCheck** loc, Check* in) {
+    {
+        uint len = 0;
+        Check* cur = in;
+        while (cur) { len++; cur = cur->next; }
+        *loc = alloc_repr(len * sizeof(Check));
+    }
+    // no local variables during checks
+    nbloc = 0;
+    locs = NULL;
+    procname = "reachability checks";
+
+    uint n = 0;
+    Check* cur = in;
+    while (cur) {
+        (*loc)[n].cond = tr_expr(cur->cond);
+        (*loc)[n].code = NULL;
+        n++;
+        cur = cur->next;
+    }
+    return n;
+}
+
+RExpr* tr_expr (Expr* in) {
+    RExpr* out = alloc_repr(sizeof(RExpr));
+    out->type = in->type;
+    switch (in->type) {
+        case E_VAR:
+            out->val.var = locate_var(in->val.ident);
+            break;
+        case E_VAL:
+            out->val.digit = in->val.digit;
+            break;
+        case MATCH_ANY_BINOP():
+            out->val.binop = alloc_repr(sizeof(RBinop));
+            out->val.binop->lhs = tr_expr(in->val.binop->lhs);
+            out->val.binop->rhs = tr_expr(in->val.binop->rhs);
+            break;
+        case MATCH_ANY_MONOP():
+            out->val.subexpr = tr_expr(in->val.subexpr);
+            break;
+        default: UNREACHABLE("%d is not a valid expr type", in->type);
+    }
+    return out;
+}
+
+Var* locate_var (char* ident) {
+    for (uint i = 0; i < nbloc; i++) {
+        if (0 == strcmp(ident, locs[i].name)) {
+            return locs + i;
+        }
+    }
+    for (uint i = 0; i < nbglob; i++) {
+        if (0 == strcmp(ident, globs[i].name)) {
+            return globs + i;
+        }
+    }
+    printf("In %s\n", procname);
+    printf("Variable %s is not declared\n", ident);
+    failed = true;
+    return NULL;
+}
+
+uint tr_proc_list (RProc** loc, Proc* in) {
+    {
+        uint len = 0;
+        Proc* cur = in;
+        while (cur) { len++; cur = cur->next; }
+        *loc = alloc_repr(len * sizeof(RProc));
+    }
+    uint n = 0;
+    Proc* cur = in;
+    while (cur) {
+        RProc* out = (*loc) + n;
+        out->name = cur->name;
+        out->nbloc = tr_var_list(&out->locs, cur->locs);
+        // setup local variables just for this translation
+        nbloc = out->nbloc;
+        locs = out->locs;
+        procname = out->name;
+        tr_stmt(
+            &out->entrypoint, cur->stmts,
+            true, // advances to the end
+            NULL, // nothing to skip to
+            NULL); // nothing to break to
+        n++;
+        cur = cur->next;
+    }
+    return n;
+}
+
+RAssign* tr_assign (Assign* in) {
+    RAssign* out = alloc_repr(sizeof(RAssign));
+    out->target = locate_var(in->target);
+    out->expr = tr_expr(in->value);
+    out->code = NULL;
+    return out;
+}
+
+void tr_stmt (
+    RStep** out, Stmt* in,
+    bool advance, RStep* skipto, RStep* breakto
+) {
+    *out = alloc_repr(sizeof(RStep));
+    (*out)->assign = NULL;
+    (*out)->id = in->id;
+    switch (in->type) {
+        case S_ASSIGN:
+            (*out)->assign = tr_assign(in->val.assign);
+            // fallthrough
+        case S_SKIP:
+        case S_BREAK:
+            (*out)->nbguarded = 0;
+            (*out)->guarded = NULL;
+            if (in->type == S_BREAK) {
+                // by definition the successor of a S_BREAK is `breakto`
+                (*out)->unguarded = breakto;
+                (*out)->advance = true; // break is always a progress
+            } else if (in->type == S_SKIP) {
+                // similarly the successor of a S_SKIP is `skipto`
+                (*out)->unguarded = skipto;
+                (*out)->advance = advance;
+            } else if (in->next) {
+                (*out)->unguarded = alloc_repr(sizeof(RStep));
+                tr_stmt(
+                        &((*out)->unguarded), in->next,
+                        advance, skipto, breakto); // normal transfer
+                (*out)->advance = true; // advances to `next`
+            } else {
+                // by default, skip
+                (*out)->unguarded = skipto;
+                (*out)->advance = advance;
+            }
+            break;
+        case S_DO:
+        case S_IF:
+            (*out)->nbguarded = 0;
+            (*out)->advance = true;
+            int isdo = in->type == S_DO;
+            if (in->next) {
+                RStep* next = alloc_repr(sizeof(RStep));
+                tr_stmt(
+                    &next, in->next,
+                    advance, skipto, breakto);
+                (*out)->unguarded = tr_branch_list(
+                    &((*out)->nbguarded), &((*out)->guarded), in->val.branch,
+                    isdo ? false : true,
+                        // when `do`, skipping does not necessarily advance the computation
+                        // when `if`, skip is a progress 
+                    isdo ? *out : next,
+                        // when `do`, skip to self
+                        // when `if`, continue to successor
+                    isdo ? next : breakto);
+                        // always break to successor
+            } else {
+                (*out)->unguarded = tr_branch_list(
+                    &((*out)->nbguarded), &((*out)->guarded), in->val.branch,
+                    isdo ? false : advance,
+                        // `do`: same as above
+                        // `if`: propagate to branches
+                    isdo ? *out : skipto,
+                        // `do`: skip to self
+                        // `if`: skip makes the same progress as self
+                    isdo ? skipto : breakto);
+                        // `do`: break to parent's successor
+                        // `if`: normal break
+            }
+            break;
+        default: UNREACHABLE("%d is not a valid statement discriminant", in->type);
+    }
+}
+
+// Returns the possible else clause so that
+// the caller can set it as its unguarded branch
+RStep* tr_branch_list (
+    uint* nb, RGuard** loc, Branch* in,
+    bool advance, RStep* skipto, RStep* breakto
+) {
+    {
+        uint len = 0;
+        Branch* cur = in;
+        while (cur && cur->cond) { len++; cur = cur->next; }
+        *loc = alloc_repr(len * sizeof(RGuard));
+        *nb = len;
+    }
+    uint n = 0;
+    Branch* cur = in;
+    while (cur && cur->cond) {
+        RGuard* out = *loc + n;
+        out->cond = tr_expr(cur->cond);
+        out->code = NULL;
+        tr_stmt(
+            &out->next, cur->stmt,
+            advance, skipto, breakto);
+        n++;
+        cur = cur->next;
+    }
+    // else clause
+    if (cur) {
+        RStep* end = alloc_repr(sizeof(RStep));
+        tr_stmt(
+            &end, cur->stmt,
+            advance, skipto, breakto);
+        return end;
+    } else {
+        return NULL;
+    }
+}
+
@@ -0,0 +1,107 @@
+#ifndef REPR_H
+#define REPR_H
+
+#include "ast.h"
+
+void free_repr (); // to be called at the very end
+void* alloc_repr (size_t size); // deallocated by free_repr
+
+// A different representation, more suited for execution
+// Not a tree but an execution graph
+
+struct RExpr;
+struct RStep;
+struct RGuard;
+struct Code;
+
+// a binary operation
+typedef struct {
+    struct RExpr* lhs;
+    struct RExpr* rhs;
+} RBinop;
+
+// an expression
+typedef ExprKind RExprKind;
+typedef struct RExpr {
+    RExprKind type;
+    union {
+        Var* var;
+        uint digit;
+        RBinop* binop;
+        struct RExpr* subexpr;
+    } val;
+} RExpr;
+
+// an assignment operation
+typedef struct {
+    Var* target;
+    RExpr* expr;
+    struct Code* code; // compiled expr (see bytecode.h)
+} RAssign;
+
+// represents a choice (possibly only one solution)
+typedef struct RStep {
+    bool advance; // avoid looping during pretty-print
+    RAssign* assign; // maybe assign a new value
+    unsigned nbguarded;
+    struct RGuard* guarded; // choose any if satisfied
+    struct RStep* unguarded; // otherwise go here
+    uint id;
+    uint idx; // index in the process' steps (see layout.h)
+    bool local; // only uses local variables (see reduce.h)
+    bool fusible; // local and without guards
+} RStep;
+
+// represents a guarded instruction
+typedef struct RGuard {
+    RExpr* cond;
+    struct Code* code; // compiled cond
+    RStep* next;
+} RGuard; 
+
+// The idea behind these two structures
+// is that each step of the computation consists of
+// -> if nbguarded == 0
+//    jump to unguarded and execute it
+// -> else if one of the guarded has its guard satisfied
+//    jump to any of them and execute it
+// -> else if unguarded is not NULL execute it
+// -> else the process is blocked
+
+// a procedure
+typedef struct {
+    char* name;
+    uint nbloc;
+    Var* locs;
+    RStep* entrypoint;
+    uint nbstep; // including <END> at index 0
+    RStep** steps; // all steps reachable from entrypoint
+    uint template; // first process with the same code (see reduce.h)
+} RProc;
+
+// a reachability test
+typedef struct {
+    RExpr* cond;
+    struct Code* code; // compiled cond
+} RCheck;
+
+// a full program
+typedef struct {
+    uint nbglob;
+    uint nbvar;
+    Var* globs;
+    uint nbproc;
+    RProc* procs;
+    uint nbcheck;
+    RCheck* checks;
+    uint nbstep;
+    struct Layout* layout; // how states are packed
+    struct Symmetry* symmetry; // interchangeable processes
+    uint nbfold; // expressions rewritten (see simplify.h)
+    uint nbprune; // guards and else clauses removed
+} RProg;
+
+// `simplify` enables the rewriting of expressions
+RProg* tr_prog (Prog* in, bool simplify);
+
+#endif // REPR_H
@@ -0,0 +1,42 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include "prelude.h"
+
+// Pseudo-random numbers for the simulation (xoshiro256**)
+// Each thread has its own generator so that no state is shared
+// and a run can be replayed from its seed.
+
+typedef struct {
+    ull s [4];
+} Rng;
+
+// Generator used by the range operator and the random execution
+extern _Thread_local Rng thread_rng;
+
+// Any seed is fine, including 0
+void rng_seed (Rng* rng, ull seed);
+
+static inline ull rng_rotl (ull x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline ull rng_next (Rng* rng) {
+    ull* s = rng->s;
+    ull res = rng_rotl(s[1] * 5, 7) * 9;
+    ull t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return res;
+}
+
+// Uniform in [0, n), n > 0
+static inline uint rng_below (Rng* rng, ull n) {
+    return (uint)(((rng_next(rng) >> 32) * n) >> 32);
+}
+
+#endif // RNG_H
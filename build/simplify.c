@@ -0,0 +1,248 @@
+#include "simplify.h"
+#include "prelude.h"
+#include <limits.h>
+
+RExpr* new_val (int val) {
+    RExpr* expr = alloc_repr(sizeof(RExpr));
+    expr->type = E_VAL;
+    expr->val.digit = (uint)val;
+    return expr;
+}
+
+// Value of a constant expression, INT_MIN if it always fails
+bool get_const (RExpr* expr, int* val) {
+    if (expr->type == E_VAL) {
+        *val = (int)expr->val.digit;
+        return true;
+    }
+    if ((expr->type == E_DIV || expr->type == E_MOD)
+        && expr->val.binop->lhs->type == E_VAL
+        && expr->val.binop->rhs->type == E_VAL
+        && expr->val.binop->rhs->val.digit == 0
+    ) {
+        *val = INT_MIN;
+        return true;
+    }
+    return false;
+}
+
+// Old subexpressions stay registered and are freed with the rest
+void set_const (RExpr* expr, int val) {
+    if (val == INT_MIN) {
+        // no literal for an error, use the canonical one
+        RBinop* binop = alloc_repr(sizeof(RBinop));
+        binop->lhs = new_val(1);
+        binop->rhs = new_val(0);
+        expr->type = E_DIV;
+        expr->val.binop = binop;
+    } else {
+        expr->type = E_VAL;
+        expr->val.digit = (uint)val;
+    }
+}
+
+// Whether evaluating the expression may produce INT_MIN
+bool may_fail (RExpr* expr) {
+    int val;
+    if (get_const(expr, &val)) return val == INT_MIN;
+    switch (expr->type) {
+        case E_VAR: return false;
+        case MATCH_ANY_BINOP(): {
+            if (expr->type == E_RANGE) return true;
+            if (expr->type == E_DIV || expr->type == E_MOD) {
+                int div;
+                if (!get_const(expr->val.binop->rhs, &div) || div == 0) return true;
+            }
+            return may_fail(expr->val.binop->lhs) || may_fail(expr->val.binop->rhs);
+        }
+        case MATCH_ANY_MONOP(): return may_fail(expr->val.subexpr);
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+}
+
+// Whether the expression only takes the values 0 and 1 (or fails)
+bool is_bool (RExpr* expr) {
+    int val;
+    if (get_const(expr, &val)) return val == 0 || val == 1;
+    switch (expr->type) {
+        case E_LT: case E_GT: case E_EQ: case E_GEQ: case E_LEQ:
+        case E_AND: case E_OR: case E_NOT:
+            return true;
+        default: return false;
+    }
+}
+
+// Same as the evaluation in exec.c, overflow wraps around
+int fold_binop (RExprKind type, int lhs, int rhs) {
+    if (lhs == INT_MIN || rhs == INT_MIN) return INT_MIN;
+    long long l = lhs, r = rhs;
+    long long res;
+    switch (type) {
+        case E_LT: return lhs < rhs;
+        case E_GT: return lhs > rhs;
+        case E_EQ: return lhs == rhs;
+        case E_GEQ: return lhs >= rhs;
+        case E_LEQ: return lhs <= rhs;
+        case E_AND: return lhs && rhs;
+        case E_OR: return lhs || rhs;
+        case E_ADD: res = l + r; break;
+        case E_SUB: res = l - r; break;
+        case E_MUL: res = l * r; break;
+        case E_DIV: if (!rhs) return INT_MIN; res = l / r; break;
+        case E_MOD: if (!rhs) return INT_MIN; res = l % r; break;
+        default: UNREACHABLE("%d is not a foldable operator", type);
+    }
+    return (int)(unsigned)(ull)res;
+}
+
+// Replace `expr` by its subexpression `sub`
+void replace (RExpr* expr, RExpr* sub) {
+    memcpy(expr, sub, sizeof(RExpr));
+}
+
+// Rewrite one binary node whose operands are already simplified
+// Returns false if nothing could be done
+bool simplify_binop (RExpr* expr) {
+    RExpr* lhs = expr->val.binop->lhs;
+    RExpr* rhs = expr->val.binop->rhs;
+    int l, r;
+    bool lconst = get_const(lhs, &l);
+    bool rconst = get_const(rhs, &r);
+    if (lconst && l == INT_MIN) {
+        // the right operand is not even evaluated
+        set_const(expr, INT_MIN);
+        return true;
+    }
+    if (expr->type == E_RANGE) {
+        if (!lconst || !rconst) return false;
+        if (l > r) { set_const(expr, INT_MIN); return true; }
+        if (l == r) { set_const(expr, l); return true; }
+        return false;
+    }
+    if (rconst && r == INT_MIN) {
+        set_const(expr, INT_MIN);
+        return true;
+    }
+    if (lconst && rconst) {
+        if (get_const(expr, &l)) return false; // already canonical `1 / 0`
+        set_const(expr, fold_binop(expr->type, l, r));
+        return true;
+    }
+    if (!lconst && !rconst) return false;
+    // exactly one constant operand `c`, the other one is `x`
+    int c = lconst ? l : r;
+    RExpr* x = lconst ? rhs : lhs;
+    switch (expr->type) {
+        case E_ADD:
+            if (c == 0) { replace(expr, x); return true; }
+            return false;
+        case E_SUB:
+            if (rconst && c == 0) { replace(expr, x); return true; }
+            return false;
+        case E_MUL:
+            if (c == 1) { replace(expr, x); return true; }
+            if (c == 0 && !may_fail(x)) { set_const(expr, 0); return true; }
+            return false;
+        case E_DIV:
+            if (rconst && c == 0) { set_const(expr, INT_MIN); return true; }
+            if (rconst && c == 1) { replace(expr, x); return true; }
+            return false;
+        case E_MOD:
+            if (rconst && c == 0) { set_const(expr, INT_MIN); return true; }
+            if (rconst && (c == 1 || c == -1) && !may_fail(x)) { set_const(expr, 0); return true; }
+            return false;
+        case E_AND:
+            if (c == 0 && !may_fail(x)) { set_const(expr, 0); return true; }
+            if (c != 0 && is_bool(x)) { replace(expr, x); return true; }
+            return false;
+        case E_OR:
+            if (c != 0 && !may_fail(x)) { set_const(expr, 1); return true; }
+            if (c == 0 && is_bool(x)) { replace(expr, x); return true; }
+            return false;
+        default:
+            return false;
+    }
+}
+
+// Bottom-up rewriting, counts the rewritten nodes
+void simplify_expr (RExpr* expr, uint* nbfold) {
+    switch (expr->type) {
+        case E_VAR: case E_VAL: return;
+        case MATCH_ANY_BINOP():
+            simplify_expr(expr->val.binop->lhs, nbfold);
+            simplify_expr(expr->val.binop->rhs, nbfold);
+            // operands are already simplified, so is what replaces `expr`
+            if (simplify_binop(expr)) (*nbfold)++;
+            return;
+        case MATCH_ANY_MONOP(): {
+            RExpr* sub = expr->val.subexpr;
+            simplify_expr(sub, nbfold);
+            int val;
+            if (get_const(sub, &val)) {
+                if (expr->type == E_NOT) {
+                    set_const(expr, !val);
+                } else {
+                    set_const(expr, (val == INT_MIN) ? INT_MIN : -val);
+                }
+                (*nbfold)++;
+            } else if (sub->type == expr->type && (expr->type == E_NEG
+                || (is_bool(sub->val.subexpr) && !may_fail(sub->val.subexpr)))
+            ) {
+                // `--x` and `!!b` (`!!(1 / 0)` is 1)
+                replace(expr, sub->val.subexpr);
+                (*nbfold)++;
+            }
+            return;
+        }
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+}
+
+void simplify_step (RStep* step, bool* seen, uint* nbfold, uint* nbprune) {
+    if (!step || seen[step->id]) return;
+    seen[step->id] = true;
+    if (step->assign) simplify_expr(step->assign->expr, nbfold);
+    uint kept = 0;
+    bool always = false; // some guard is always satisfied
+    for (uint i = 0; i < step->nbguarded; i++) {
+        RGuard* guard = step->guarded + i;
+        simplify_expr(guard->cond, nbfold);
+        int val;
+        if (get_const(guard->cond, &val)) {
+            if (val == 0 || val == INT_MIN) {
+                (*nbprune)++;
+                continue;
+            }
+            always = true;
+        }
+        step->guarded[kept++] = *guard;
+    }
+    if (step->nbguarded > 0 && kept == 0 && !step->unguarded) {
+        // statically blocked
+        step->guarded[0].cond = new_val(0);
+        step->guarded[0].next = step;
+        kept = 1;
+    }
+    step->nbguarded = kept;
+    if (always && step->unguarded) {
+        step->unguarded = NULL;
+        (*nbprune)++;
+    }
+    for (uint i = 0; i < step->nbguarded; i++) {
+        simplify_step(step->guarded[i].next, seen, nbfold, nbprune);
+    }
+    simplify_step(step->unguarded, seen, nbfold, nbprune);
+}
+
+void simplify_prog (RProg* prog) {
+    bool seen [prog->nbstep + 1];
+    memset(seen, false, sizeof(seen));
+    prog->nbfold = 0;
+    prog->nbprune = 0;
+    for (uint p = 0; p < prog->nbproc; p++) {
+        simplify_step(prog->procs[p].entrypoint, seen, &prog->nbfold, &prog->nbprune);
+    }
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        simplify_expr(prog->checks[k].cond, &prog->nbfold);
+    }
+}
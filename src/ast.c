@@ -2,30 +2,27 @@
 #include "prelude.h"
 #include "memreg.h"
 
-MemBlock* ast_alloc_registry = NULL;
-MemBlock* var_alloc_registry = NULL;
+Arena* ast_arena = NULL;
+Arena* var_arena = NULL;
 
-void register_ast (void* ptr) { register_alloc(&ast_alloc_registry, ptr); }
-void register_var (void* ptr) { register_alloc(&var_alloc_registry, ptr); }
-void free_ast () { register_free(&ast_alloc_registry); }
-void free_var () { register_free(&var_alloc_registry); }
+void* alloc_ast (size_t size) { return arena_alloc(&ast_arena, size); }
+void* alloc_var (size_t size) { return arena_alloc(&var_arena, size); }
+void free_ast () { arena_free(&ast_arena); }
+void free_var () { arena_free(&var_arena); }
 
 // Parse-time expression builders
-// (also handle registering to memblocks)
+// (also handle allocating from the arenas)
 
 Var* make_ident (char* name, uint id) {
-    Var* var = malloc(sizeof(Var));
-    register_var(var);
-    var->name = strdup(name);
-    register_var(var->name);
+    Var* var = alloc_var(sizeof(Var));
+    var->name = arena_strdup(&var_arena, name);
     var->next = NULL;
     var->id = id;
     return var;
 }
 
 Prog* make_prog (Var* globs, Proc* procs, Check* checks) {
-    Prog* prog = malloc(sizeof(Prog));
-    register_ast(prog);
+    Prog* prog = alloc_ast(sizeof(Prog));
     prog->globs = globs;
     prog->procs = procs;
     prog->checks = checks;
@@ -33,16 +30,14 @@ Prog* make_prog (Var* globs, Proc* procs, Check* checks) {
 }
 
 Assign* make_assign (char* target, Expr* value) {
-    Assign* assign = malloc(sizeof(Assign));
-    register_ast(assign);
+    Assign* assign = alloc_ast(sizeof(Assign));
     assign->target = target;
     assign->value = value;
     return assign;
 }
 
 Branch* make_branch (Expr* cond, Stmt* stmt) {
-    Branch* branch = malloc(sizeof(Branch));
-    register_ast(branch);
+    Branch* branch = alloc_ast(sizeof(Branch));
     branch->cond = cond;
     branch->stmt = stmt;
     branch->next = NULL;
@@ -50,8 +45,7 @@ Branch* make_branch (Expr* cond, Stmt* stmt) {
 }
 
 Stmt* make_stmt (StmtKind type, uint id) {
-    Stmt* stmt = malloc(sizeof(Stmt));
-    register_ast(stmt);
+    Stmt* stmt = alloc_ast(sizeof(Stmt));
     stmt->type = type;
     stmt->next = NULL;
     stmt->id = id;
@@ -59,8 +53,7 @@ Stmt* make_stmt (StmtKind type, uint id) {
 }
 
 Proc* make_proc (char* name, Var* locs, Stmt* stmts) {
-    Proc* proc = malloc(sizeof(Proc));
-    register_ast(proc);
+    Proc* proc = alloc_ast(sizeof(Proc));
     proc->name = name;
     proc->locs = locs;
     proc->stmts = stmts;
@@ -69,23 +62,20 @@ Proc* make_proc (char* name, Var* locs, Stmt* stmts) {
 }
 
 Binop* make_binop (Expr* lhs, Expr* rhs) {
-    Binop* binop = malloc(sizeof(Binop));
-    register_ast(binop);
+    Binop* binop = alloc_ast(sizeof(Binop));
     binop->lhs = lhs;
     binop->rhs = rhs;
     return binop;
 }
 
 Expr* make_expr (ExprKind type) {
-    Expr* expr = malloc(sizeof(Expr));
-    register_ast(expr);
+    Expr* expr = alloc_ast(sizeof(Expr));
     expr->type = type;
     return expr;
 }
 
 Check* make_check (Expr* cond) {
-    Check* check = malloc(sizeof(Check));
-    register_ast(check);
+    Check* check = alloc_ast(sizeof(Check));
     check->cond = cond;
     check->next = NULL;
     return check;
@@ -0,0 +1,406 @@
+#include "bytecode.h"
+#include "prelude.h"
+#include "rng.h"
+#include <limits.h>
+
+// Whether evaluating the expression has side effects (draws a random number)
+bool has_range (RExpr* expr) {
+    switch (expr->type) {
+        case E_VAR: case E_VAL: return false;
+        case MATCH_ANY_BINOP():
+            return expr->type == E_RANGE
+                || has_range(expr->val.binop->lhs)
+                || has_range(expr->val.binop->rhs);
+        case MATCH_ANY_MONOP(): return has_range(expr->val.subexpr);
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+}
+
+uint code_size (RExpr* expr) {
+    switch (expr->type) {
+        case E_VAR: case E_VAL: return 1;
+        case MATCH_ANY_BINOP():
+            return code_size(expr->val.binop->lhs)
+                + code_size(expr->val.binop->rhs)
+                + (has_range(expr->val.binop->rhs) ? 2 : 1);
+        case MATCH_ANY_MONOP(): return code_size(expr->val.subexpr) + 1;
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+}
+
+Opcode opcode (RExprKind type) {
+    switch (type) {
+        case E_LT: return OP_LT;
+        case E_GT: return OP_GT;
+        case E_EQ: return OP_EQ;
+        case E_GEQ: return OP_GEQ;
+        case E_LEQ: return OP_LEQ;
+        case E_AND: return OP_AND;
+        case E_OR: return OP_OR;
+        case E_ADD: return OP_ADD;
+        case E_SUB: return OP_SUB;
+        case E_MUL: return OP_MUL;
+        case E_MOD: return OP_MOD;
+        case E_DIV: return OP_DIV;
+        case E_RANGE: return OP_RANGE;
+        case E_NOT: return OP_NOT;
+        case E_NEG: return OP_NEG;
+        default: UNREACHABLE("%d is not an operator", type);
+    }
+}
+
+// Emit the instructions that leave the value of `expr` in register `dst`
+// Registers above `dst` are free to use as temporaries
+void emit_expr (RExpr* expr, Layout* layout, Code* code, uint dst) {
+    if (dst + 1 > code->nbreg) code->nbreg = dst + 1;
+    Instr* instr;
+    switch (expr->type) {
+        case E_VAL:
+            instr = code->instrs + code->nbinstr++;
+            instr->op = OP_VAL;
+            instr->dst = dst;
+            instr->arg.val = (int)(expr->val.digit);
+            return;
+        case E_VAR:
+            instr = code->instrs + code->nbinstr++;
+            instr->op = OP_VAR;
+            instr->dst = dst;
+            instr->arg.var = layout->vars[expr->val.var->id];
+            return;
+        case MATCH_ANY_BINOP(): {
+            emit_expr(expr->val.binop->lhs, layout, code, dst);
+            Instr* skip = NULL;
+            if (has_range(expr->val.binop->rhs)) {
+                skip = code->instrs + code->nbinstr++;
+                skip->op = OP_SKIP;
+                skip->dst = dst;
+            }
+            uint before = code->nbinstr;
+            emit_expr(expr->val.binop->rhs, layout, code, dst + 1);
+            if (skip) skip->arg.jump = code->nbinstr - before;
+            instr = code->instrs + code->nbinstr++;
+            instr->op = opcode(expr->type);
+            instr->dst = dst;
+            instr->arg.reg.lhs = dst;
+            instr->arg.reg.rhs = dst + 1;
+            return;
+        }
+        case MATCH_ANY_MONOP():
+            emit_expr(expr->val.subexpr, layout, code, dst);
+            instr = code->instrs + code->nbinstr++;
+            instr->op = opcode(expr->type);
+            instr->dst = dst;
+            instr->arg.reg.lhs = dst;
+            return;
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+}
+
+ull mul_sat (ull lhs, ull rhs) {
+    return (lhs && rhs > ULLONG_MAX / lhs) ? ULLONG_MAX : lhs * rhs;
+}
+
+// How many values an expression takes at most when every range takes
+// all of its values (INT_MIN included), `*widest` receives the largest
+// number for any subexpression, which is what a register may have to hold
+ull count_values (RExpr* expr, Layout* layout, ull* widest) {
+    ull nb;
+    switch (expr->type) {
+        case E_VAR: case E_VAL: nb = 1; break;
+        case MATCH_ANY_BINOP(): {
+            ull lhs = count_values(expr->val.binop->lhs, layout, widest);
+            ull rhs = count_values(expr->val.binop->rhs, layout, widest);
+            nb = mul_sat(lhs, rhs);
+            switch (expr->type) {
+                case E_ADD: case E_SUB: case E_MUL: case E_MOD: case E_DIV: break;
+                case E_RANGE: {
+                    // each choice fails or is between the bounds of the operands
+                    Interval lo = eval_bounds(expr->val.binop->lhs, layout->bounds);
+                    Interval hi = eval_bounds(expr->val.binop->rhs, layout->bounds);
+                    nb = (hi.hi >= lo.lo) ? (ull)(hi.hi - lo.lo) + 2 : 1;
+                    break;
+                }
+                default: nb = nb < 3 ? nb : 3; // 0, 1 or INT_MIN
+            }
+            break;
+        }
+        case MATCH_ANY_MONOP():
+            nb = count_values(expr->val.subexpr, layout, widest);
+            if (expr->type == E_NOT) nb = nb < 3 ? nb : 3;
+            break;
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+    if (nb > *widest) *widest = nb;
+    return nb;
+}
+
+Code* compile_expr (RExpr* expr, Layout* layout) {
+    Code* code = alloc_repr(sizeof(Code));
+    code->instrs = alloc_repr((code_size(expr) + 1) * sizeof(Instr));
+    code->nbinstr = 0;
+    code->nbreg = 0;
+    code->nondet = has_range(expr);
+    ull widest = 1;
+    if (code->nondet) count_values(expr, layout, &widest);
+    code->span = (widest < UINT_MAX) ? (uint)widest : UINT_MAX;
+    emit_expr(expr, layout, code, 0);
+    Instr* ret = code->instrs + code->nbinstr++;
+    ret->op = OP_RET;
+    ret->dst = 0;
+    return code;
+}
+
+void compile_prog (RProg* prog) {
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        for (uint s = 1; s < proc->nbstep; s++) {
+            RStep* step = proc->steps[s];
+            if (step->assign) {
+                step->assign->code = compile_expr(step->assign->expr, prog->layout);
+            }
+            for (uint i = 0; i < step->nbguarded; i++) {
+                step->guarded[i].code = compile_expr(step->guarded[i].cond, prog->layout);
+            }
+        }
+    }
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        prog->checks[k].code = compile_expr(prog->checks[k].cond, prog->layout);
+    }
+}
+
+// Dispatch: with GCC/clang each handler jumps directly to the next one
+// (computed goto), otherwise fall back to a switch in a loop
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#define DISPATCH goto *labels[ip->op];
+#define CASE(o) do_##o:
+#define NEXT goto *labels[(++ip)->op]
+#else
+#define DISPATCH for (;;) switch (ip->op)
+#define CASE(o) case o:
+#define NEXT ip++; continue
+#endif
+
+#define REG(r) regs[ip->arg.reg.r]
+
+// INT_MIN in either operand is an error and bubbles up
+#define BINOP(o, body) \
+    CASE(o) { \
+        int lhs = REG(lhs); \
+        if (lhs == INT_MIN) { \
+            regs[ip->dst] = INT_MIN; \
+        } else { \
+            int rhs = REG(rhs); \
+            if (rhs == INT_MIN) { \
+                regs[ip->dst] = INT_MIN; \
+            } else { \
+                body; \
+            } \
+        } \
+        NEXT; \
+    }
+
+#define ARITH(o, op) BINOP(o, regs[ip->dst] = lhs op rhs)
+#define DIVIDE(o, op) BINOP(o, regs[ip->dst] = (rhs == 0) ? INT_MIN : lhs op rhs)
+
+int exec_code (Code* code, Vec vec) {
+#ifdef __GNUC__
+    static const void* labels [NB_OPCODE] = {
+        [OP_VAL] = &&do_OP_VAL, [OP_VAR] = &&do_OP_VAR,
+        [OP_LT] = &&do_OP_LT, [OP_GT] = &&do_OP_GT, [OP_EQ] = &&do_OP_EQ,
+        [OP_GEQ] = &&do_OP_GEQ, [OP_LEQ] = &&do_OP_LEQ,
+        [OP_AND] = &&do_OP_AND, [OP_OR] = &&do_OP_OR,
+        [OP_ADD] = &&do_OP_ADD, [OP_SUB] = &&do_OP_SUB, [OP_MUL] = &&do_OP_MUL,
+        [OP_MOD] = &&do_OP_MOD, [OP_DIV] = &&do_OP_DIV,
+        [OP_RANGE] = &&do_OP_RANGE,
+        [OP_NOT] = &&do_OP_NOT, [OP_NEG] = &&do_OP_NEG,
+        [OP_SKIP] = &&do_OP_SKIP,
+        [OP_RET] = &&do_OP_RET,
+    };
+#endif
+    int regs [code->nbreg];
+    Instr* ip = code->instrs;
+    DISPATCH {
+        CASE(OP_VAL) {
+            regs[ip->dst] = ip->arg.val;
+            NEXT;
+        }
+        CASE(OP_VAR) {
+            Field* f = &ip->arg.var;
+            regs[ip->dst] = (int)((long long)get_field(f, vec) + f->base);
+            NEXT;
+        }
+        ARITH(OP_LT, <)
+        ARITH(OP_GT, >)
+        ARITH(OP_EQ, ==)
+        ARITH(OP_GEQ, >=)
+        ARITH(OP_LEQ, <=)
+        ARITH(OP_AND, &&)
+        ARITH(OP_OR, ||)
+        ARITH(OP_ADD, +)
+        ARITH(OP_SUB, -)
+        ARITH(OP_MUL, *)
+        DIVIDE(OP_MOD, %)
+        DIVIDE(OP_DIV, /)
+        BINOP(OP_RANGE,
+            regs[ip->dst] = (lhs > rhs) ? INT_MIN
+                : lhs + (int)rng_below(&thread_rng, (ull)((long long)rhs - lhs + 1)))
+        CASE(OP_NOT) {
+            regs[ip->dst] = !REG(lhs);
+            NEXT;
+        }
+        CASE(OP_NEG) {
+            regs[ip->dst] = -REG(lhs);
+            NEXT;
+        }
+        CASE(OP_SKIP) {
+            if (regs[ip->dst] == INT_MIN) ip += ip->arg.jump;
+            NEXT;
+        }
+        CASE(OP_RET) {
+            return regs[0];
+        }
+#ifndef __GNUC__
+        default: UNREACHABLE("%d is not an opcode", ip->op);
+#endif
+    }
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+// Exhaustive evaluation (see exec_code_all)
+
+// Values held by a register, `vals` has room for 2 * max of them
+// and duplicates are only removed once it is full
+typedef struct {
+    int* vals;
+    uint nb;
+} ValueSet;
+
+int cmp_int (const void* lhs, const void* rhs) {
+    int l = *(const int*)lhs;
+    int r = *(const int*)rhs;
+    return (l > r) - (l < r);
+}
+
+// Sort and remove duplicates, then keep the `max` smallest values
+void normalize_set (ValueSet* set, uint max, bool* truncated) {
+    qsort(set->vals, set->nb, sizeof(int), cmp_int);
+    uint nb = 0;
+    for (uint i = 0; i < set->nb; i++) {
+        if (nb == 0 || set->vals[i] != set->vals[nb - 1]) set->vals[nb++] = set->vals[i];
+    }
+    if (nb > max) {
+        nb = max;
+        *truncated = true;
+    }
+    set->nb = nb;
+}
+
+void add_value (ValueSet* set, int val, uint max, bool* truncated) {
+    if (set->nb == 2 * max) normalize_set(set, max, truncated);
+    set->vals[set->nb++] = val;
+}
+
+// Same semantics as the binary instructions of exec_code
+int apply_binop (Opcode op, int lhs, int rhs) {
+    if (lhs == INT_MIN || rhs == INT_MIN) return INT_MIN;
+    switch (op) {
+        case OP_LT: return lhs < rhs;
+        case OP_GT: return lhs > rhs;
+        case OP_EQ: return lhs == rhs;
+        case OP_GEQ: return lhs >= rhs;
+        case OP_LEQ: return lhs <= rhs;
+        case OP_AND: return lhs && rhs;
+        case OP_OR: return lhs || rhs;
+        case OP_ADD: return lhs + rhs;
+        case OP_SUB: return lhs - rhs;
+        case OP_MUL: return lhs * rhs;
+        case OP_MOD: return (rhs == 0) ? INT_MIN : lhs % rhs;
+        case OP_DIV: return (rhs == 0) ? INT_MIN : lhs / rhs;
+        default: UNREACHABLE("%d is not a binary operator", op);
+    }
+}
+
+// All values of `{lhs..rhs}`, at most `max` of them
+void add_range (ValueSet* set, int lhs, int rhs, uint max, bool* truncated) {
+    if (lhs == INT_MIN || rhs == INT_MIN || lhs > rhs) {
+        add_value(set, INT_MIN, max, truncated);
+        return;
+    }
+    long long hi = rhs;
+    if (hi - lhs >= max) {
+        hi = lhs + (long long)max - 1;
+        *truncated = true;
+    }
+    for (long long val = lhs; val <= hi; val++) {
+        add_value(set, (int)val, max, truncated);
+    }
+}
+
+uint code_work (Code* code, uint max) {
+    // one more set receives the result of binary operators
+    return (code->nbreg + 1) * 2 * code_values(code, max);
+}
+
+uint exec_code_all (Code* code, Vec vec, int* work, int* out, uint max, bool* truncated) {
+    max = code_values(code, max);
+    uint room = 2 * max;
+    ValueSet regs [code->nbreg + 1];
+    for (uint r = 0; r <= code->nbreg; r++) {
+        regs[r].vals = work + r * room;
+        regs[r].nb = 0;
+    }
+    ValueSet* res = regs + code->nbreg;
+    // the right operand of a failed left operand is evaluated all the same,
+    // the values do not depend on how many numbers are drawn
+    for (Instr* ip = code->instrs; ip->op != OP_RET; ip++) {
+        ValueSet* dst = regs + ip->dst;
+        switch (ip->op) {
+            case OP_VAL:
+                dst->vals[0] = ip->arg.val;
+                dst->nb = 1;
+                break;
+            case OP_VAR: {
+                Field* f = &ip->arg.var;
+                dst->vals[0] = (int)((long long)get_field(f, vec) + f->base);
+                dst->nb = 1;
+                break;
+            }
+            case OP_NOT: case OP_NEG:
+                for (uint i = 0; i < dst->nb; i++) {
+                    int val = dst->vals[i];
+                    dst->vals[i] = (ip->op == OP_NOT) ? !val : -val;
+                }
+                normalize_set(dst, max, truncated);
+                break;
+            case OP_SKIP: break;
+            default: {
+                ValueSet* lhs = regs + ip->arg.reg.lhs;
+                ValueSet* rhs = regs + ip->arg.reg.rhs;
+                res->nb = 0;
+                for (uint i = 0; i < lhs->nb; i++) {
+                    for (uint j = 0; j < rhs->nb; j++) {
+                        if (ip->op == OP_RANGE) {
+                            add_range(res, lhs->vals[i], rhs->vals[j], max, truncated);
+                        } else {
+                            add_value(res, apply_binop(ip->op, lhs->vals[i], rhs->vals[j]), max, truncated);
+                        }
+                    }
+                }
+                normalize_set(res, max, truncated);
+                // swap rather than copy
+                int* vals = dst->vals;
+                *dst = *res;
+                res->vals = vals;
+                break;
+            }
+        }
+    }
+    uint nb = regs[0].nb;
+    memcpy(out, regs[0].vals, nb * sizeof(int));
+    return nb;
+}
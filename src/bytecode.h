@@ -0,0 +1,87 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "repr.h"
+#include "layout.h"
+#include "prelude.h"
+
+// Expressions are compiled to a flat sequence of instructions
+// for a register machine, rather than evaluated by walking the tree.
+//
+// Each instruction writes to register `dst`, binary and unary operators
+// read their operands from registers `lhs` and `rhs`.
+// Register allocation follows the depth in the tree:
+// the value of the root ends up in register 0.
+//
+// The semantics are exactly those of `eval_expr`:
+// INT_MIN signals a division by zero (or an empty range),
+// and propagates through binary operators.
+// When the right operand contains a range, OP_SKIP jumps over it
+// if the left operand already failed so that `rand` is called
+// exactly as often as by the recursive evaluation.
+
+typedef enum {
+    OP_VAL, OP_VAR,
+    OP_LT, OP_GT, OP_EQ, OP_GEQ, OP_LEQ,
+    OP_AND, OP_OR,
+    OP_ADD, OP_SUB, OP_MUL, OP_MOD, OP_DIV,
+    OP_RANGE,
+    OP_NOT, OP_NEG,
+    OP_SKIP,
+    OP_RET,
+    NB_OPCODE, // not an opcode, number of opcodes
+} Opcode;
+
+typedef struct {
+    Opcode op;
+    uint dst;
+    union {
+        int val; // OP_VAL
+        Field var; // OP_VAR
+        uint jump; // OP_SKIP: number of instructions to skip
+        struct {
+            uint lhs;
+            uint rhs;
+        } reg; // operators
+    } arg;
+} Instr;
+
+typedef struct Code {
+    uint nbinstr;
+    uint nbreg;
+    Instr* instrs;
+    bool nondet; // contains a range
+    uint span; // values a register may hold at most with exec_code_all
+} Code;
+
+// Compile all guards, assignments and checks of the program
+// (requires the layout to be known)
+void compile_prog (RProg* prog);
+
+Code* compile_expr (RExpr* expr, Layout* layout);
+
+int exec_code (Code* code, Vec vec);
+
+// Whether evaluating the expression draws a random number
+bool has_range (RExpr* expr);
+
+// Exhaustive counterpart of `exec_code`: each range takes all of its
+// values instead of a random one, and `out` receives every value the
+// expression may take, sorted and without duplicates (INT_MIN first if
+// some choice fails). Registers hold sets of values, so that each
+// instruction is executed once however many choices there are.
+// At most `max` values are kept, as well as values of a range,
+// `*truncated` is set when some were dropped.
+// `work` has room for `code_work(code, max)` values and `out` for
+// `code_values(code, max)`, which are bounded by the ranges of the
+// expression and the bounds of its variables rather than by `max` alone.
+// Returns the number of values written to `out`, at least 1
+uint exec_code_all (Code* code, Vec vec, int* work, int* out, uint max, bool* truncated);
+
+static inline uint code_values (Code* code, uint max) {
+    return code->span < max ? code->span : max;
+}
+
+uint code_work (Code* code, uint max);
+
+#endif // BYTECODE_H
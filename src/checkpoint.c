@@ -0,0 +1,376 @@
+#include "checkpoint.h"
+#include "bytecode.h"
+#include "prelude.h"
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+
+// "flngckpt", first and last word of a checkpoint
+const ull CHECKPOINT_MAGIC = 0x74706b63676e6c66;
+const ull CHECKPOINT_VERSION = 2;
+// Ends the diffs
+const ull NO_DIFF = ~(ull)0;
+// Kinds of visited sets
+enum { SET_EXACT, SET_BITS };
+
+ull mix (ull h, ull val) {
+    ull pair [2] = { h, val };
+    return hash_key(pair, 2);
+}
+
+ull mix_field (ull h, Field* f) {
+    h = mix(h, f->word);
+    h = mix(h, f->shift);
+    h = mix(h, f->mask);
+    return mix(h, (ull)f->base);
+}
+
+ull mix_code (ull h, Code* code) {
+    h = mix(h, code->nbinstr);
+    for (uint i = 0; i < code->nbinstr; i++) {
+        Instr* ip = code->instrs + i;
+        h = mix(h, ((ull)ip->op << 32) | ip->dst);
+        switch (ip->op) {
+            case OP_VAL: h = mix(h, (uint)ip->arg.val); break;
+            case OP_VAR: h = mix_field(h, &ip->arg.var); break;
+            case OP_SKIP: h = mix(h, ip->arg.jump); break;
+            case OP_NOT: case OP_NEG: h = mix(h, ip->arg.reg.lhs); break;
+            case OP_RET: break;
+            default: h = mix(h, ((ull)ip->arg.reg.lhs << 32) | ip->arg.reg.rhs); break;
+        }
+    }
+    return h;
+}
+
+ull mix_next (ull h, RStep* step) {
+    return mix(h, step ? step->idx : 0);
+}
+
+// What each step does: its assignment, its guards and where they lead
+ull mix_steps (ull h, RProc* proc) {
+    for (uint s = 1; s < proc->nbstep; s++) {
+        RStep* step = proc->steps[s];
+        h = mix_next(h, step->unguarded);
+        if (step->assign) {
+            h = mix(h, step->assign->target->id);
+            h = mix_code(h, step->assign->code);
+        }
+        h = mix(h, step->nbguarded);
+        for (uint i = 0; i < step->nbguarded; i++) {
+            h = mix_code(h, step->guarded[i].code);
+            h = mix_next(h, step->guarded[i].next);
+        }
+    }
+    return h;
+}
+
+// Identifies the program (its layout and the code of every step and
+// check) and the options that change which states are visited,
+// or how they are stored
+ull fingerprint (RProg* prog, ExecOpts* opts) {
+    Layout* layout = prog->layout;
+    ull h = mix(CHECKPOINT_VERSION, layout->nbword);
+    h = mix(h, prog->nbvar);
+    h = mix(h, prog->nbproc);
+    h = mix(h, prog->nbstep);
+    h = mix(h, prog->nbcheck);
+    for (uint i = 0; i < prog->nbvar; i++) h = mix_field(h, layout->vars + i);
+    for (uint p = 0; p < prog->nbproc; p++) {
+        h = mix_field(h, layout->procs + p);
+        h = mix(h, prog->procs[p].nbstep);
+        h = mix_steps(h, prog->procs + p);
+    }
+    for (uint k = 0; k < prog->nbcheck; k++) h = mix_code(h, prog->checks[k].code);
+    h = mix(h, opts->por);
+    h = mix(h, opts->symmetry);
+    h = mix(h, opts->compact);
+    h = mix(h, opts->bitstate);
+    return mix(h, opts->range_max);
+}
+
+ull bits_of (double val) {
+    ull res;
+    memcpy(&res, &val, sizeof(ull));
+    return res;
+}
+
+double double_of (ull val) {
+    double res;
+    memcpy(&res, &val, sizeof(ull));
+    return res;
+}
+
+typedef struct {
+    FILE* f;
+    bool failed;
+    uint width; // of a state
+    HashSet* written; // position of each diff already written
+    ull nbdiff;
+    Diff** chain; // diffs not written yet, from the last one up
+    uint chain_capacity;
+} Saver;
+
+void put_words (Saver* sv, ull* buf, uint nb) {
+    if (fwrite(buf, sizeof(ull), nb, sv->f) != nb) sv->failed = true;
+}
+
+void put_word (Saver* sv, ull val) {
+    put_words(sv, &val, 1);
+}
+
+void put_key (void* ctx, ull* key, ull hashed) {
+    Saver* sv = ctx;
+    put_word(sv, hashed);
+    put_words(sv, key, sv->width);
+}
+
+// Position of the diff, written along with its ancestors
+// the first time it is met
+ull diff_index (Saver* sv, Diff* diff) {
+    uint nb = 0;
+    ull parent = 0;
+    for (Diff* d = diff; d; d = d->parent) {
+        ull key = (ull)(uintptr_t)d;
+        bool added;
+        ull* pos = get_or_insert(sv->written, &key, hash_key(&key, 1), &added);
+        if (!added) {
+            parent = pos[0];
+            break;
+        }
+        if (nb == sv->chain_capacity) {
+            sv->chain_capacity *= 2;
+            sv->chain = realloc(sv->chain, sv->chain_capacity * sizeof(Diff*));
+        }
+        sv->chain[nb++] = d;
+    }
+    while (nb--) {
+        Diff* d = sv->chain[nb];
+        ull rec [3];
+        rec[0] = parent;
+        rec[1] = ((ull)d->pid_advance << 32) | (d->new_step ? d->new_step->id + 1 : 0);
+        rec[2] = ((ull)(d->var_assign ? d->var_assign->id + 1 : 0) << 32) | (uint)d->val_assign;
+        put_words(sv, rec, 3);
+        parent = ++sv->nbdiff;
+        ull key = (ull)(uintptr_t)d;
+        bool added;
+        get_or_insert(sv->written, &key, hash_key(&key, 1), &added)[0] = parent;
+    }
+    return parent;
+}
+
+bool write_checkpoint (
+    FILE* f, RProg* prog, ExecOpts* opts, Snapshot* snap,
+    SharedSet* seen, BitState* bits, Chunk** level, ull level_size
+) {
+    Saver sv;
+    sv.f = f;
+    sv.failed = false;
+    sv.width = key_width(prog);
+    put_word(&sv, CHECKPOINT_MAGIC);
+    put_word(&sv, fingerprint(prog, opts));
+    put_word(&sv, snap->depth);
+    put_word(&sv, snap->nbstate);
+    put_word(&sv, bits_of(snap->nbrepr));
+    put_word(&sv, snap->nbfused);
+    put_word(&sv, snap->nbtrans);
+    put_word(&sv, snap->maxfrontier);
+    put_word(&sv, bits_of(snap->seconds));
+    for (uint k = 0; k < prog->nbcheck; k++) put_word(&sv, bits_of(snap->found_at[k]));
+    if (seen) {
+        put_word(&sv, SET_EXACT);
+        put_word(&sv, sharedset_size(seen));
+        sharedset_foreach(seen, put_key, &sv);
+    } else {
+        ull nbword;
+        ull* words = bitstate_words(bits, &nbword);
+        put_word(&sv, SET_BITS);
+        put_word(&sv, nbword);
+        if (fwrite(words, sizeof(ull), nbword, f) != nbword) sv.failed = true;
+    }
+    sv.written = create_hashmap(1, 1);
+    sv.nbdiff = 0;
+    sv.chain_capacity = 64;
+    sv.chain = malloc(sv.chain_capacity * sizeof(Diff*));
+    Compute* comp = make_compute(prog, NULL);
+    // all diffs first
+    for (uint k = 0; k < prog->nbcheck; k++) diff_index(&sv, snap->sat[k]);
+    ull nbstate = 0;
+    for (ull c = 0; c < level_size; c++) {
+        for (uint i = 0; i < chunk_len(level[c]); i++) {
+            chunk_get(level[c], i, comp);
+            diff_index(&sv, comp->diff);
+            nbstate++;
+        }
+    }
+    put_word(&sv, NO_DIFF);
+    // then the references to them
+    for (uint k = 0; k < prog->nbcheck; k++) put_word(&sv, diff_index(&sv, snap->sat[k]));
+    put_word(&sv, nbstate);
+    for (ull c = 0; c < level_size; c++) {
+        for (uint i = 0; i < chunk_len(level[c]); i++) {
+            chunk_get(level[c], i, comp);
+            put_word(&sv, diff_index(&sv, comp->diff));
+            put_words(&sv, comp->vec, sv.width);
+        }
+    }
+    put_word(&sv, CHECKPOINT_MAGIC);
+    free_compute(comp);
+    free(sv.chain);
+    free_hashset(sv.written);
+    return !sv.failed;
+}
+
+// Size of the buffer of the file, checkpoints are written sequentially
+const size_t CHECKPOINT_BUFFER = 1 << 20;
+
+pid_t save_checkpoint (
+    char* fname, RProg* prog, ExecOpts* opts, Snapshot* snap,
+    SharedSet* seen, BitState* bits, Chunk** level, ull level_size
+) {
+    pid_t pid = fork();
+    if (pid) return pid;
+    // child: the memory is a copy of the parent's at the time of the fork
+    size_t len = strlen(fname);
+    char tmp [len + 5];
+    strcpy(tmp, fname);
+    strcpy(tmp + len, ".tmp");
+    FILE* f = fopen(tmp, "wb");
+    if (!f) {
+        fprintf(stderr, "Cannot write checkpoint '%s': %s\n", tmp, strerror(errno));
+        _exit(1);
+    }
+    setvbuf(f, NULL, _IOFBF, CHECKPOINT_BUFFER);
+    bool ok = write_checkpoint(f, prog, opts, snap, seen, bits, level, level_size);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmp, fname)) {
+        fprintf(stderr, "Cannot write checkpoint '%s': %s\n", fname, strerror(errno));
+        remove(tmp);
+        _exit(1);
+    }
+    _exit(0);
+}
+
+typedef struct {
+    FILE* f;
+    bool failed;
+} Loader;
+
+void get_words (Loader* ld, ull* buf, ull nb) {
+    if (!ld->failed && fread(buf, sizeof(ull), nb, ld->f) != nb) ld->failed = true;
+}
+
+ull get_word (Loader* ld) {
+    ull val = 0;
+    get_words(ld, &val, 1);
+    return val;
+}
+
+bool read_checkpoint (
+    Loader* ld, RProg* prog, ExecOpts* opts, Snapshot* snap,
+    SharedSet* seen, BitState* bits, WorkList* todo
+) {
+    if (get_word(ld) != CHECKPOINT_MAGIC || get_word(ld) != fingerprint(prog, opts)) return false;
+    snap->depth = (uint)get_word(ld);
+    snap->nbstate = get_word(ld);
+    snap->nbrepr = double_of(get_word(ld));
+    snap->nbfused = get_word(ld);
+    snap->nbtrans = get_word(ld);
+    snap->maxfrontier = get_word(ld);
+    snap->seconds = double_of(get_word(ld));
+    for (uint k = 0; k < prog->nbcheck; k++) snap->found_at[k] = double_of(get_word(ld));
+    uint width = key_width(prog);
+    ull key [width + 1];
+    if (get_word(ld) != (seen ? SET_EXACT : SET_BITS)) return false;
+    if (seen) {
+        ull nbkey = get_word(ld);
+        for (ull i = 0; i < nbkey && !ld->failed; i++) {
+            ull hashed = get_word(ld);
+            get_words(ld, key, width);
+            try_insert_shared(seen, key, hashed);
+        }
+    } else {
+        ull nbword;
+        ull* words = bitstate_words(bits, &nbword);
+        if (get_word(ld) != nbword) return false;
+        get_words(ld, words, nbword);
+        bitstate_recount(bits);
+    }
+    // steps and variables by id
+    RStep* steps [prog->nbstep + 1];
+    Var* vars [prog->nbvar + 1];
+    memset(steps, 0, sizeof(steps));
+    memset(vars, 0, sizeof(vars));
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        for (uint s = 1; s < proc->nbstep; s++) steps[proc->steps[s]->id] = proc->steps[s];
+        for (uint i = 0; i < proc->nbloc; i++) vars[proc->locs[i].id] = proc->locs + i;
+    }
+    for (uint i = 0; i < prog->nbglob; i++) vars[prog->globs[i].id] = prog->globs + i;
+    ull nbdiff = 1;
+    ull capacity = 1024;
+    Diff** diffs = malloc(capacity * sizeof(Diff*));
+    diffs[0] = NULL;
+    bool ok = true;
+    for (;;) {
+        ull parent = get_word(ld);
+        if (ld->failed || parent == NO_DIFF) break;
+        ull rec [2];
+        get_words(ld, rec, 2);
+        ull step = rec[0] & 0xffffffff;
+        ull var = rec[1] >> 32;
+        if (parent >= nbdiff || step > prog->nbstep || var > prog->nbvar) {
+            ok = false;
+            break;
+        }
+        if (nbdiff == capacity) {
+            capacity *= 2;
+            diffs = realloc(diffs, capacity * sizeof(Diff*));
+        }
+        Diff* diff = make_sat_diff(diffs[parent]);
+        diff->pid_advance = (uint)(rec[0] >> 32);
+        diff->new_step = step ? steps[step - 1] : NULL;
+        diff->var_assign = var ? vars[var - 1] : NULL;
+        diff->val_assign = (int)(uint)rec[1];
+        diffs[nbdiff++] = diff;
+    }
+    for (uint k = 0; k < prog->nbcheck && ok; k++) {
+        ull idx = get_word(ld);
+        if (idx >= nbdiff) ok = false;
+        else snap->sat[k] = diffs[idx];
+    }
+    ull nbstate = ok ? get_word(ld) : 0;
+    Compute* comp = make_compute(prog, NULL);
+    for (ull i = 0; i < nbstate && ok && !ld->failed; i++) {
+        ull idx = get_word(ld);
+        get_words(ld, comp->vec, width);
+        if (idx >= nbdiff) ok = false;
+        else {
+            comp->diff = diffs[idx];
+            comp->hashed = hash_fields(prog, comp->vec);
+            enqueue(todo, comp);
+        }
+    }
+    free_compute(comp);
+    free(diffs);
+    return ok && get_word(ld) == CHECKPOINT_MAGIC && !ld->failed;
+}
+
+bool load_checkpoint (
+    char* fname, RProg* prog, ExecOpts* opts, Snapshot* snap,
+    SharedSet* seen, BitState* bits, WorkList* todo
+) {
+    Loader ld;
+    ld.f = fopen(fname, "rb");
+    if (!ld.f) {
+        fprintf(stderr, "Cannot read checkpoint '%s': %s\n", fname, strerror(errno));
+        return false;
+    }
+    ld.failed = false;
+    setvbuf(ld.f, NULL, _IOFBF, CHECKPOINT_BUFFER);
+    bool ok = read_checkpoint(&ld, prog, opts, snap, seen, bits, todo);
+    fclose(ld.f);
+    if (!ok) {
+        fprintf(stderr, "'%s' is not a complete checkpoint of this program with these options\n", fname);
+    }
+    return ok;
+}
@@ -2,32 +2,38 @@
 #include "prelude.h"
 #include "hashset.h"
 #include "memreg.h"
+#include "reduce.h"
+#include "bytecode.h"
+#include "external.h"
+#include "rng.h"
+#include "heuristic.h"
+#include "profile.h"
+#include "checkpoint.h"
+#include <errno.h>
 #include <limits.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
 
 
-MemBlock* sat_alloc_registry = NULL;
-void register_sat (void* ptr) { register_alloc(&sat_alloc_registry, ptr); }
-void free_sat () { register_free(&sat_alloc_registry); }
+Arena* sat_arena = NULL;
+void* alloc_sat (size_t size) { return arena_alloc(&sat_arena, size); }
+void free_sat () { arena_free(&sat_arena); }
 
-Env blank_env (RProg* prog) {
-    Env env = malloc(prog->nbvar * sizeof(int));
+void init_vec (RProg* prog, Vec vec) {
+    memset(vec, 0, prog->layout->nbword * sizeof(ull));
     for (uint i = 0; i < prog->nbvar; i++) {
-        env[i] = 0;
+        set_var(prog, vec, i, 0);
     }
-    return env;
-}
-
-State init_state (RProg* prog) {
-    State state = malloc(prog->nbproc * sizeof(RStep*));
     for (uint i = 0; i < prog->nbproc; i++) {
-        state[i] = prog->procs[i].entrypoint;
+        set_step(prog, vec, i, prog->procs[i].entrypoint);
     }
-    return state;
 }
 
-Diff* make_diff (Diff* parent) {
-    Diff* diff = malloc(sizeof(Diff));
-    register_sat(diff);
+// Diffs are allocated from `arena` so that each thread may use its own
+Diff* make_diff (Arena** arena, Diff* parent) {
+    Diff* diff = ARENA_NEW(arena, Diff);
     diff->parent = parent;
     diff->pid_advance = (uint)(-1);
     diff->new_step = NULL;
@@ -37,39 +43,39 @@ Diff* make_diff (Diff* parent) {
     return diff;
 }
 
-Diff* dup_diff (Diff* src) {
-    Diff* cpy = malloc(sizeof(Diff));
-    register_sat(cpy);
+Diff* make_sat_diff (Diff* parent) {
+    return make_diff(&sat_arena, parent);
+}
+
+Diff* dup_diff (Arena** arena, Diff* src) {
+    Diff* cpy = ARENA_NEW(arena, Diff);
     memcpy(cpy, src, sizeof(Diff));
     return cpy;
 }
 
 // duplicate a computation to avoid side effects
-Compute* dup_compute (Compute* comp) {
-    Compute* cpy = malloc(sizeof(Compute));
-    // copy by reference so that sat is updated
-    cpy->sat = comp->sat;
-    cpy->prog = comp->prog;
-    cpy->diff = comp->diff;
-    // copy by value so that environment is not modified
-    size_t envsize = comp->prog->nbvar * sizeof(int);
-    size_t statesize = comp->prog->nbproc * sizeof(RStep);
-    cpy->env = malloc(envsize);
-    cpy->state = malloc(statesize);
-    memcpy(cpy->env, comp->env, envsize);
-    memcpy(cpy->state, comp->state, statesize);
-    return cpy;
+// (sat is shared by reference so that it is updated,
+// the vector is copied by value so that it is not modified)
+void copy_compute (Compute* dst, Compute* src) {
+    memcpy(dst, src, sizeof(Compute) + src->prog->layout->nbword * sizeof(ull));
+}
+
+Compute* make_compute (RProg* prog, Sat* sat) {
+    Compute* comp = malloc(sizeof(Compute) + prog->layout->nbword * sizeof(ull));
+    comp->sat = sat;
+    comp->prog = prog;
+    comp->diff = make_diff(&sat_arena, NULL);
+    init_vec(prog, comp->vec);
+    comp->hashed = hash_fields(prog, comp->vec);
+    return comp;
 }
 
 void free_compute (Compute* comp) {
-    free(comp->env);
-    free(comp->state);
     free(comp);
 }
 
 Sat* blank_sat (RProg* prog) {
-    Sat* sat = malloc(prog->nbcheck * sizeof(Compute*));
-    register_sat(sat);
+    Sat* sat = alloc_sat(prog->nbcheck * sizeof(Compute*));
     for (uint i = 0; i < prog->nbcheck; i++) {
         sat[i] = NULL;
     }
@@ -79,7 +85,7 @@ Sat* blank_sat (RProg* prog) {
 // Macro concatenation for concise and extensible operator definition
 #define APP_BIN_E_LT <
 #define APP_BIN_E_GT >
-#define APP_BIN_E_LEQ >=
+#define APP_BIN_E_LEQ <=
 #define APP_BIN_E_GEQ >=
 #define APP_BIN_E_EQ ==
 #define APP_BIN_E_AND &&
@@ -100,15 +106,15 @@ Sat* blank_sat (RProg* prog) {
     o: return APP_MON_##o val
 
 // Straightforward expression evaluation
-int eval_expr (RExpr* expr, Env env) {
-    fflush(stdout);
+// (reference for the bytecode in bytecode.h, which is used instead)
+int eval_expr (RExpr* expr, RProg* prog, Vec vec) {
     switch (expr->type) {
-        case E_VAR: return env[expr->val.var->id];
+        case E_VAR: return get_var(prog, vec, expr->val.var->id);
         case E_VAL: return (int)(expr->val.digit);
         case MATCH_ANY_BINOP(): {
-            int lhs = eval_expr(expr->val.binop->lhs, env);
+            int lhs = eval_expr(expr->val.binop->lhs, prog, vec);
             if (lhs == INT_MIN) return INT_MIN; // divzero error bubbles up
-            int rhs = eval_expr(expr->val.binop->rhs, env);
+            int rhs = eval_expr(expr->val.binop->rhs, prog, vec);
             if (rhs == INT_MIN) return INT_MIN;
             if (rhs == 0 && (expr->type == E_DIV || expr->type == E_MOD)) {
                 return INT_MIN; // raise division error
@@ -128,13 +134,13 @@ int eval_expr (RExpr* expr, Env env) {
                 case APPLY_BINOP(lhs, E_MOD, rhs);
                 case E_RANGE:
                     if (lhs > rhs) return INT_MIN;
-                    int pick = lhs + (rand() % (rhs - lhs + 1));
+                    int pick = lhs + (int)rng_below(&thread_rng, (ull)((long long)rhs - lhs + 1));
                     return pick;
                 default: UNREACHABLE("%d is not a binary operator", expr->type);
             }
         }
         case MATCH_ANY_MONOP(): {
-            int val = eval_expr(expr->val.subexpr, env);
+            int val = eval_expr(expr->val.subexpr, prog, vec);
             switch (expr->type) {
                 case APPLY_MONOP(E_NOT, val);
                 case APPLY_MONOP(E_NEG, val);
@@ -145,31 +151,58 @@ int eval_expr (RExpr* expr, Env env) {
     }
 }
 
-bool exec_assign (RAssign* assign, Env env, Diff* diff) {
-    int val = eval_expr(assign->expr, env);
+// Update one field and the hash of the state along with it
+void assign_var (Compute* comp, uint id, int val) {
+    Field* f = comp->prog->layout->vars + id;
+    comp->hashed -= hash_field(id, get_field(f, comp->vec));
+    set_var(comp->prog, comp->vec, id, val);
+    comp->hashed += hash_field(id, get_field(f, comp->vec));
+}
+
+void advance_step (Compute* comp, uint pid, RStep* step) {
+    RProg* prog = comp->prog;
+    Field* f = prog->layout->procs + pid;
+    comp->hashed -= hash_field(prog->nbvar + pid, get_field(f, comp->vec));
+    set_step(prog, comp->vec, pid, step);
+    comp->hashed += hash_field(prog->nbvar + pid, get_field(f, comp->vec));
+}
+
+bool exec_assign (RAssign* assign, Compute* comp, Diff* diff) {
+    int val = exec_code(assign->code, comp->vec);
     if (val != INT_MIN) {
-        env[assign->target->id] = eval_expr(assign->expr, env);
+        assign_var(comp, assign->target->id, val);
         diff->var_assign = assign->target;
-        diff->val_assign = env[assign->target->id];
+        diff->val_assign = val;
         return 1;
     } else {
         return 0;
     }
 }
 
+// How a walk chooses between satisfied guards (see swarm below)
+typedef enum { BIAS_UNIFORM, BIAS_FIRST, BIAS_LAST, NB_BIAS } GuardBias;
+
+// Pick one of `nb` choices, biased ones favor an end 3 times out of 4
+uint biased_choice (GuardBias bias, uint nb) {
+    if (bias != BIAS_UNIFORM && rng_below(&thread_rng, 4) > 0) {
+        return bias == BIAS_FIRST ? 0 : nb - 1;
+    }
+    return rng_below(&thread_rng, nb);
+}
+
 // Randomly choose a successor of a determined computation step
 // and update the environment
 // Returns the new state
-RStep* exec_step_random (RStep* step, Env env, Diff* diff) {
+RStep* exec_step_random (RStep* step, Compute* comp, Diff* diff, GuardBias bias) {
     if (!step) return step; // NULL, blocked
     if (step->assign) {
-        if (!exec_assign(step->assign, env, diff)) return step;
+        if (!exec_assign(step->assign, comp, diff)) return step;
         // Blocked by null division
     }
     uint satisfied [step->nbguarded];
     uint nbsat = 0;
     for (uint i = 0; i < step->nbguarded; i++) {
-        int res = eval_expr(step->guarded[i].cond, env);
+        int res = exec_code(step->guarded[i].code, comp->vec);
         if (res && res != INT_MIN) {
             satisfied[nbsat++] = i;
         }
@@ -183,144 +216,1291 @@ RStep* exec_step_random (RStep* step, Env env, Diff* diff) {
             diff->new_step = step; // blocked
         }
     } else {
-        int choice = rand() % (int)nbsat;
+        uint choice = biased_choice(bias, nbsat);
         diff->new_step = step->guarded[satisfied[choice]].next; // satisfied guard
     }
     return diff->new_step;
 }
 
-// Randomly execute a program (many times)
-Sat* exec_prog_random (RProg* prog) {
-    Compute comp;
-    comp.sat = blank_sat(prog);
-    comp.prog = prog;
-    for (uint j = 0; j < 100; j++) {
-        comp.env = blank_env(prog); 
-        comp.state = init_state(prog);
-        comp.diff = make_diff(NULL);
-        for (uint i = 0; i < 100; i++) {
-            // update reachability
-            // (do this _before_ simulating a step so that if a check
-            // is initially valid it is counted)
-            for (uint k = 0; k < prog->nbcheck; k++) {
-                int res = eval_expr(prog->checks[k].cond, comp.env);
-                if (res == 0 || res == INT_MIN) continue;
-                if (!comp.sat[k]) {
-                    // found a solution
-                    comp.sat[k] = comp.diff;
-                } else if (comp.sat[k] && comp.diff->depth < comp.sat[k]->depth) {
-                    // found a shorter solution
-                    comp.sat[k] = comp.diff;
-                }
+// Random execution: independent walks are spread over a pool of threads
+// Walk `w` draws its numbers from a generator seeded by the seed and `w`
+// alone, so the results do not depend on the number of threads
+// (unless the run is cut short by the time budget or by convergence).
+
+// Swarm: each walk draws its own strategy from its generator, i.e. a
+// weight for each process, a bias in the choice of guards and a depth.
+// Once all checks have a witness, walks stop at the depth of the
+// longest one since they cannot improve any.
+typedef struct {
+    uint depth;
+    GuardBias bias;
+    uint total; // sum of the weights
+    uint* weights; // of each process
+} Strategy;
+
+// Weights are powers of 2 up to 2^SWARM_SKEW
+const uint SWARM_SKEW = 4;
+
+void draw_strategy (Strategy* strat, RandOpts* opts, uint nbproc) {
+    if (!opts->swarm) {
+        strat->depth = opts->depth;
+        strat->bias = BIAS_UNIFORM;
+        strat->total = nbproc;
+        for (uint p = 0; p < nbproc; p++) strat->weights[p] = 1;
+        return;
+    }
+    // from a quarter to twice the depth
+    strat->depth = opts->depth / 4 + rng_below(&thread_rng, (ull)opts->depth * 7 / 4 + 1);
+    strat->bias = (GuardBias)rng_below(&thread_rng, NB_BIAS);
+    strat->total = 0;
+    for (uint p = 0; p < nbproc; p++) {
+        strat->weights[p] = 1u << rng_below(&thread_rng, SWARM_SKEW + 1);
+        strat->total += strat->weights[p];
+    }
+}
+
+uint choose_proc (Strategy* strat, uint nbproc) {
+    uint r = rng_below(&thread_rng, strat->total);
+    for (uint p = 0; p < nbproc; p++) {
+        if (r < strat->weights[p]) return p;
+        r -= strat->weights[p];
+    }
+    UNREACHABLE("weights sum to %d", strat->total);
+}
+
+// Adaptive mode: discovery rate is measured over this many walks
+const uint CONVERGE_WINDOW = 100;
+// and the simulation stops once fewer steps than this lead to a new state
+const double CONVERGE_RATE = 0.001;
+
+typedef struct Simulation Simulation;
+
+// Private to each thread
+typedef struct {
+    Simulation* sim;
+    Sat* sat; // shortest witness found by this thread
+    uint* walk; // walk that found it
+    Compute* comp; // state of the current walk
+    Arena* arena; // diffs of the witnesses found by this thread
+    Arena* scratch; // diffs of the current walk
+    pthread_t thread;
+    ull nbwalk;
+    ull nbstep;
+} Walker;
+
+// Shared by all threads
+struct Simulation {
+    RProg* prog;
+    RandOpts* opts;
+    uint claimed; // walks started
+    bool stop;
+    struct timespec start;
+    uint nbwalker;
+    Walker* walkers;
+    bool* hit; // checks satisfied by some walk
+    uint nbhit;
+    uint* best; // depth of the shortest witness of each check
+    // adaptive mode
+    SharedSet* seen; // states visited by all walks
+    pthread_mutex_t window_lock;
+    uint window_walks;
+    ull window_steps;
+    ull window_new;
+};
+
+double elapsed (struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+long peak_memory () {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0;
+    return usage.ru_maxrss;
+}
+
+// Returns the number of states visited for the first time
+ull run_walk (Walker* walker, Compute* comp, uint w) {
+    Simulation* sim = walker->sim;
+    RProg* prog = sim->prog;
+    uint width = prog->layout->nbword;
+    ull nbnew = 0;
+    bool found = false;
+    rng_seed(&thread_rng, sim->opts->seed ^ ((ull)w << 32));
+    uint weights [prog->nbproc + 1];
+    Strategy strat;
+    strat.weights = weights;
+    draw_strategy(&strat, sim->opts, prog->nbproc);
+    if (sim->opts->swarm && __atomic_load_n(&sim->nbhit, __ATOMIC_RELAXED) == prog->nbcheck) {
+        // nothing left to find, only shorter witnesses
+        uint longest = 0;
+        for (uint k = 0; k < prog->nbcheck; k++) {
+            uint best = __atomic_load_n(sim->best + k, __ATOMIC_RELAXED);
+            if (best > longest) longest = best;
+        }
+        if (longest < strat.depth) strat.depth = longest;
+    }
+    init_vec(prog, comp->vec);
+    comp->diff = make_diff(&walker->scratch, NULL);
+    for (uint i = 0; i < strat.depth; i++) {
+        if (sim->seen && try_insert_shared(sim->seen, comp->vec, hash_key(comp->vec, width))) {
+            nbnew++;
+        }
+        // update reachability
+        // (do this _before_ simulating a step so that if a check
+        // is initially valid it is counted)
+        for (uint k = 0; k < prog->nbcheck; k++) {
+            int res = exec_code(prog->checks[k].code, comp->vec);
+            if (res == 0 || res == INT_MIN) continue;
+            // walks of a thread are in increasing order,
+            // an earlier one wins ties
+            if (!walker->sat[k] || comp->diff->depth < walker->sat[k]->depth) {
+                walker->sat[k] = comp->diff;
+                walker->walk[k] = w;
+                found = true;
             }
-            // duplicate zero check, preferred to duplicating all the other code
-            if (!prog->nbproc) break;
-
-            // choose the process that will advance
-            uint procid = (uint)rand() % prog->nbproc;
-            // calculate next step of the computation
-            Diff* old_diff = comp.diff;
-            RStep* old_step = comp.state[procid];
-            comp.diff = make_diff(old_diff);
-            comp.diff->pid_advance = procid;
-            comp.state[procid] = exec_step_random(old_step, comp.env, comp.diff);
-            if (comp.diff->new_step == old_step) {
-                // process is blocked, do not record empty diff
-                comp.diff = old_diff;
+            if (!__atomic_exchange_n(sim->hit + k, true, __ATOMIC_RELAXED)) {
+                __atomic_add_fetch(&sim->nbhit, 1, __ATOMIC_RELAXED);
             }
+            uint depth = comp->diff->depth;
+            uint best = __atomic_load_n(sim->best + k, __ATOMIC_RELAXED);
+            while (depth < best && !__atomic_compare_exchange_n(sim->best + k, &best, depth,
+                true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        }
+        // duplicate zero check, preferred to duplicating all the other code
+        if (!prog->nbproc) break;
+        walker->nbstep++;
+
+        // choose the process that will advance
+        uint procid = choose_proc(&strat, prog->nbproc);
+        // calculate next step of the computation
+        Diff* old_diff = comp->diff;
+        RStep* old_step = get_step(prog, comp->vec, procid);
+        comp->diff = make_diff(&walker->scratch, old_diff);
+        comp->diff->pid_advance = procid;
+        set_step(prog, comp->vec, procid, exec_step_random(old_step, comp, comp->diff, strat.bias));
+        if (comp->diff->new_step == old_step) {
+            // process is blocked, do not record empty diff
+            comp->diff = old_diff;
         }
-        free(comp.env);
-        free(comp.state);
     }
-    return comp.sat;
+    // keep the diffs only if they are part of a witness
+    if (found) {
+        arena_merge(&walker->arena, &walker->scratch);
+    } else {
+        arena_free(&walker->scratch);
+    }
+    walker->nbwalk++;
+    return nbnew;
 }
 
-// Explore (i.e. add to the worklist with their updated environment)
-// all successors of a state
-void exec_step_all_proc (HashSet* seen, WorkList* todo, uint pid, Compute* comp) {
-    RStep* step = comp->state[pid];
-    if (!step) return; // NULL, blocked
-    Diff* diff = make_diff(comp->diff);
-    diff->pid_advance = pid;
+// Decide whether to start more walks
+void end_walk (Walker* walker, ull nbstep, ull nbnew) {
+    Simulation* sim = walker->sim;
+    if (sim->opts->time_budget && elapsed(&sim->start) >= (double)sim->opts->time_budget) {
+        __atomic_store_n(&sim->stop, true, __ATOMIC_RELAXED);
+    }
+    if (!sim->opts->adaptive) return;
+    uint nbhit = __atomic_load_n(&sim->nbhit, __ATOMIC_RELAXED);
+    if (nbhit > 0 && nbhit == sim->prog->nbcheck) {
+        // every check has a witness
+        __atomic_store_n(&sim->stop, true, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_lock(&sim->window_lock);
+    sim->window_walks++;
+    sim->window_steps += nbstep;
+    sim->window_new += nbnew;
+    if (sim->window_walks == CONVERGE_WINDOW) {
+        if ((double)sim->window_new < CONVERGE_RATE * (double)sim->window_steps) {
+            __atomic_store_n(&sim->stop, true, __ATOMIC_RELAXED);
+        }
+        sim->window_walks = 0;
+        sim->window_steps = 0;
+        sim->window_new = 0;
+    }
+    pthread_mutex_unlock(&sim->window_lock);
+}
+
+void* walker_loop (void* arg) {
+    Walker* walker = arg;
+    Simulation* sim = walker->sim;
+    uint w;
+    while (!__atomic_load_n(&sim->stop, __ATOMIC_RELAXED)
+        && (w = __atomic_fetch_add(&sim->claimed, 1, __ATOMIC_RELAXED)) < sim->opts->walks
+    ) {
+        ull before = walker->nbstep;
+        ull nbnew = run_walk(walker, walker->comp, w);
+        end_walk(walker, walker->nbstep - before, nbnew);
+    }
+    return NULL;
+}
+
+// Randomly execute a program (many times)
+Sat* exec_prog_random (RProg* prog, RandOpts* opts, RandStats* stats) {
+    Simulation sim;
+    sim.prog = prog;
+    sim.opts = opts;
+    sim.claimed = 0;
+    sim.stop = false;
+    clock_gettime(CLOCK_MONOTONIC, &sim.start);
+    sim.nbwalker = opts->threads ? opts->threads : 1;
+    sim.walkers = malloc(sim.nbwalker * sizeof(Walker));
+    sim.hit = calloc(prog->nbcheck + 1, sizeof(bool));
+    sim.nbhit = 0;
+    sim.best = malloc((prog->nbcheck + 1) * sizeof(uint));
+    for (uint k = 0; k < prog->nbcheck; k++) sim.best[k] = UINT_MAX;
+    sim.seen = NULL;
+    if (opts->adaptive) {
+        sim.seen = create_sharedset(key_width(prog), sim.nbwalker);
+        pthread_mutex_init(&sim.window_lock, NULL);
+        sim.window_walks = 0;
+        sim.window_steps = 0;
+        sim.window_new = 0;
+    }
+    for (uint t = 0; t < sim.nbwalker; t++) {
+        Walker* walker = sim.walkers + t;
+        walker->sim = &sim;
+        walker->sat = blank_sat(prog);
+        walker->walk = malloc((prog->nbcheck + 1) * sizeof(uint));
+        walker->comp = make_compute(prog, walker->sat);
+        walker->arena = NULL;
+        walker->scratch = NULL;
+        walker->nbwalk = 0;
+        walker->nbstep = 0;
+    }
+    // the main thread acts as walker 0
+    for (uint t = 1; t < sim.nbwalker; t++) {
+        pthread_create(&sim.walkers[t].thread, NULL, walker_loop, sim.walkers + t);
+    }
+    walker_loop(sim.walkers);
+    for (uint t = 1; t < sim.nbwalker; t++) {
+        pthread_join(sim.walkers[t].thread, NULL);
+    }
+    stats->seconds = elapsed(&sim.start);
+    stats->nbwalk = 0;
+    stats->nbstep = 0;
+    stats->nbstate = 0;
+    // keep the shortest witness, the earliest walk on ties
+    Sat* sat = blank_sat(prog);
+    uint best [prog->nbcheck + 1];
+    for (uint t = 0; t < sim.nbwalker; t++) {
+        Walker* walker = sim.walkers + t;
+        for (uint k = 0; k < prog->nbcheck; k++) {
+            Diff* found = walker->sat[k];
+            if (!found) continue;
+            if (!sat[k] || found->depth < sat[k]->depth
+                || (found->depth == sat[k]->depth && walker->walk[k] < best[k])
+            ) {
+                sat[k] = found;
+                best[k] = walker->walk[k];
+            }
+        }
+        stats->nbwalk += walker->nbwalk;
+        stats->nbstep += walker->nbstep;
+        arena_merge(&sat_arena, &walker->arena);
+        free(walker->walk);
+        free_compute(walker->comp);
+    }
+    if (opts->adaptive) {
+        stats->nbstate = sharedset_size(sim.seen);
+        free_sharedset(sim.seen);
+        pthread_mutex_destroy(&sim.window_lock);
+    }
+    free(sim.hit);
+    free(sim.best);
+    free(sim.walkers);
+    return sat;
+}
+
+// Exhaustive exploration is a breadth-first search performed level by level:
+// all states at depth d are expanded (possibly by several threads at once)
+// before any state at depth d+1. This preserves the guarantee that the
+// first time a check is satisfied is with a shortest trace, counted in
+// transitions (which fuse several steps under --compact).
+
+typedef struct Explorer Explorer;
+
+// Private to each thread
+typedef struct {
+    Explorer* ex;
+    WorkList* next; // successors found during the current level
+    Compute* current; // state being expanded
+    Compute* scratch; // successors are built here
+    Arena* arena; // diffs allocated by this thread
+    pthread_t thread;
+    ull nbstate; // states visited by this thread
+    double nbrepr; // number of states they stand for (see reduce.h)
+    ull nbfused; // steps fused into the transitions that led to these states
+    ull nbtrans; // transitions executed by this thread
+    Profile* profile; // counters of --profile, NULL without
+    EvalBuf* eval; // room to evaluate ranges
+} Worker;
+
+// Shared by all threads
+struct Explorer {
+    RProg* prog;
+    ExecOpts* opts;
+    Sat* sat;
+    SharedSet* seen;
+    BitState* bits; // used instead of `seen` with bitstate hashing
+    Collapse* collapse; // states in `seen` are collapsed, NULL if not
+    uint nbworker;
+    Worker* workers;
+    // current level, claimed by workers one chunk at a time
+    Chunk** level;
+    ull level_size; // number of chunks
+    ull level_capacity;
+    ull claimed;
+    bool done;
+    pthread_barrier_t start;
+    pthread_barrier_t end;
+    pthread_mutex_t sat_lock;
+    struct timespec clock; // when the exploration started
+    double* found_at; // seconds until each check was satisfied
+    uint remaining; // targeted checks not satisfied yet
+    bool stop; // all of them are
+    // progress of the search, for --stats and --progress
+    uint depth; // current level, or deepest state expanded
+    ull frontier; // states waiting to be expanded
+    ull maxfrontier;
+    double next_report; // time of the next progress line
+    SetStats visited; // of the set of visited states, once it is no longer used
+    // checkpoints, breadth-first only
+    pid_t saver; // process writing the last one, -1 once it is done
+    double next_checkpoint;
+};
+
+void print_progress (double now, ull nbstate, ull nbtrans, uint depth, ull frontier) {
+    fprintf(stderr, "[%.0fs] %llu states, %llu transitions, depth %u, frontier %llu,"
+        " %.0f states/s, peak memory %.1fMB\n",
+        now, nbstate, nbtrans, depth, frontier,
+        now > 0 ? (double)nbstate / now : 0, (double)peak_memory() / 1024);
+}
+
+// Print a progress line if it is time to
+// (only from the main thread, the other threads may be updating
+// their counters meanwhile)
+void report_progress (Explorer* ex) {
+    if (!ex->opts->progress) return;
+    double now = elapsed(&ex->clock);
+    if (now < ex->next_report) return;
+    ex->next_report = now + ex->opts->progress;
+    ull nbstate = 0;
+    ull nbtrans = 0;
+    for (uint w = 0; w < ex->nbworker; w++) {
+        nbstate += __atomic_load_n(&ex->workers[w].nbstate, __ATOMIC_RELAXED);
+        nbtrans += __atomic_load_n(&ex->workers[w].nbtrans, __ATOMIC_RELAXED);
+    }
+    print_progress(now, nbstate, nbtrans, ex->depth, ex->frontier);
+}
+
+// To be called once `ex->sat[k]` is set (under `sat_lock` with several threads)
+void record_witness (Explorer* ex, uint k) {
+    ex->found_at[k] = elapsed(&ex->clock);
+    if (ex->opts->targets && !ex->opts->targets[k]) return;
+    if (--ex->remaining == 0 && !ex->opts->full) __atomic_store_n(&ex->stop, true, __ATOMIC_RELAXED);
+}
+
+bool stopped (Explorer* ex) {
+    return __atomic_load_n(&ex->stop, __ATOMIC_RELAXED);
+}
+
+// `hashed` is the incremental hash of `vec` (see hashset.h),
+// collapsed keys are hashed as a whole instead
+bool insert_seen (Explorer* ex, Vec vec, ull hashed) {
+    hashed = hashed ? hashed : 1; // 0 is reserved for empty slots
+    if (ex->bits) return try_insert_bits(ex->bits, hashed);
+    if (ex->collapse) {
+        uint cwidth = collapse_width(ex->collapse);
+        ull key [cwidth];
+        collapse(ex->collapse, vec, key);
+        return try_insert_shared(ex->seen, key, hash_key(key, cwidth));
+    }
+    return try_insert_shared(ex->seen, vec, hashed);
+}
+
+// Record a state as visited, returns true iff it is new
+// With symmetry reduction, what is recorded is the representative
+// of the state, but the state itself is what will be explored further
+// (so that traces remain valid executions)
+bool visit (Worker* worker, Compute* comp) {
+    Explorer* ex = worker->ex;
+    if (ex->opts->symmetry) {
+        uint width = key_width(ex->prog);
+        ull key [width];
+        memcpy(key, comp->vec, width * sizeof(ull));
+        double orbit = canonicalize(ex->prog, key);
+        // the representative differs in many fields, hash it from scratch
+        if (!insert_seen(ex, key, hash_fields(ex->prog, key))) return false;
+        worker->nbrepr += orbit;
+    } else {
+        if (!insert_seen(ex, comp->vec, comp->hashed)) return false;
+        worker->nbrepr += 1;
+    }
+    worker->nbstate++;
+    return true;
+}
+
+// Compaction: execute the fusible steps (see reduce.h) that follow
+// the current step of `pid`, stopping at the first one that blocks
+// Returns how many were executed, recorded in `fused` and `vals`
+uint run_fused (Compute* comp, uint pid, RStep** fused, int* vals) {
+    RProg* prog = comp->prog;
+    uint nb = 0;
+    RStep* step = get_step(prog, comp->vec, pid);
+    // a cycle of fusible steps is not a progress, don't loop forever
+    while (step && step->fusible && nb < prog->procs[pid].nbstep) {
+        if (step->assign) {
+            int val = exec_code(step->assign->code, comp->vec);
+            if (val == INT_MIN) break; // blocked by null division
+            assign_var(comp, step->assign->target->id, val);
+            vals[nb] = val;
+        }
+        fused[nb++] = step;
+        step = step->unguarded;
+        advance_step(comp, pid, step);
+    }
+    return nb;
+}
+
+// Record the fused steps in the trace
+Diff* fused_diffs (Arena** arena, Diff* diff, uint pid, RStep** fused, int* vals, uint nb) {
+    for (uint i = 0; i < nb; i++) {
+        diff = make_diff(arena, diff);
+        diff->pid_advance = pid;
+        diff->new_step = fused[i]->unguarded;
+        if (fused[i]->assign) {
+            diff->var_assign = fused[i]->assign->target;
+            diff->val_assign = vals[i];
+        }
+    }
+    return diff;
+}
+
+uint range_max = 1;
+bool range_truncated = false;
+
+uint max_next (RStep* step) {
+    if (step->assign && step->assign->code->nondet) return code_values(step->assign->code, range_max);
+    return step->nbguarded + 1;
+}
+
+EvalBuf* create_evalbuf (RProg* prog) {
+    EvalBuf* buf = malloc(sizeof(EvalBuf));
+    buf->work_size = 0;
+    buf->nbval = 0;
+    buf->nbsucc = 0;
+    buf->work = NULL;
+    buf->vals = NULL;
+    buf->succs = NULL;
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        for (uint s = 1; s < proc->nbstep; s++) {
+            RStep* step = proc->steps[s];
+            if (step->assign) fit_evalbuf(buf, step->assign->code);
+            for (uint i = 0; i < step->nbguarded; i++) fit_evalbuf(buf, step->guarded[i].code);
+            if (max_next(step) > buf->nbsucc) buf->nbsucc = max_next(step);
+        }
+    }
+    for (uint k = 0; k < prog->nbcheck; k++) fit_evalbuf(buf, prog->checks[k].code);
+    buf->succs = malloc(buf->nbsucc * sizeof(Succ));
+    return buf;
+}
+
+void fit_evalbuf (EvalBuf* buf, Code* code) {
+    // deterministic expressions are evaluated with exec_code
+    if (!code->nondet) return;
+    if (code_work(code, range_max) > buf->work_size) {
+        buf->work_size = code_work(code, range_max);
+        buf->work = realloc(buf->work, buf->work_size * sizeof(int));
+    }
+    if (code_values(code, range_max) > buf->nbval) {
+        buf->nbval = code_values(code, range_max);
+        buf->vals = realloc(buf->vals, buf->nbval * sizeof(int));
+    }
+}
+
+void free_evalbuf (EvalBuf* buf) {
+    free(buf->work);
+    free(buf->vals);
+    free(buf->succs);
+    free(buf);
+}
+
+uint all_values (EvalBuf* buf, Code* code, Vec vec) {
+    bool truncated = false;
+    uint nb = exec_code_all(code, vec, buf->work, buf->vals, range_max, &truncated);
+    if (truncated) __atomic_store_n(&range_truncated, true, __ATOMIC_RELAXED);
+    return nb;
+}
+
+// Whether some choice of the ranges of `code` satisfies it,
+// `*fails` is set if some other choice does not
+static bool outcomes (EvalBuf* buf, Code* code, Vec vec, bool* fails) {
+    if (!code->nondet) {
+        int res = exec_code(code, vec);
+        *fails = !res || res == INT_MIN;
+        return !*fails;
+    }
+    uint nb = all_values(buf, code, vec);
+    bool sat = false;
+    *fails = false;
+    for (uint i = 0; i < nb; i++) {
+        if (buf->vals[i] && buf->vals[i] != INT_MIN) {
+            sat = true;
+        } else {
+            *fails = true;
+        }
+    }
+    return sat;
+}
+
+bool holds (EvalBuf* buf, Code* code, Vec vec) {
+    bool fails;
+    return outcomes(buf, code, vec, &fails);
+}
+
+uint next_steps (EvalBuf* buf, RStep* step, Vec vec, Succ* next) {
     if (step->assign) {
-        if (!exec_assign(step->assign, comp->env, diff)) return;
-        // Blocked by null division
+        // an assignment is always followed by a single unguarded step
+        // (see tr_stmt in repr.c)
+        if (!step->assign->code->nondet) {
+            next[0].step = step->unguarded;
+            next[0].guard = NULL;
+            next[0].val = exec_code(step->assign->code, vec);
+            // Blocked by null division
+            return next[0].val != INT_MIN;
+        }
+        uint nb = all_values(buf, step->assign->code, vec);
+        int* vals = buf->vals;
+        // choices that fail come first, they are blocked
+        uint skip = (vals[0] == INT_MIN);
+        for (uint i = skip; i < nb; i++) {
+            next[i - skip].step = step->unguarded;
+            next[i - skip].guard = NULL;
+            next[i - skip].val = vals[i];
+        }
+        return nb - skip;
+    }
+    if (step->nbguarded == 0) {
+        // unconditional advancement
+        next[0].step = step->unguarded;
+        next[0].guard = NULL;
+        return 1;
     }
     // find all satisfied guards
-    RStep* satisfied [step->nbguarded];
+    // the guards draw their ranges independently, so the else clause
+    // is also possible as soon as each of them may fail
     uint nbsat = 0;
+    bool all_fail = true;
     for (uint i = 0; i < step->nbguarded; i++) {
-        int res = eval_expr(step->guarded[i].cond, comp->env);
-        if (res && res != INT_MIN) {
-            satisfied[nbsat++] = step->guarded[i].next;
+        bool fails;
+        if (outcomes(buf, step->guarded[i].code, vec, &fails)) {
+            next[nbsat].step = step->guarded[i].next;
+            next[nbsat++].guard = step->guarded + i;
         }
+        all_fail = all_fail && fails;
     }
-    RStep** successors;
-    uint nbsucc;
-    if (step->nbguarded == 0) {
-        // unconditional advancement
-        successors = &step->unguarded;
-        nbsucc = 1;
-    } else if (nbsat == 0) {
-        if (step->unguarded) {
-            // else clause
-            successors = &step->unguarded;
-            nbsucc = 1;
-        } else {
-            // blocked
-            nbsucc = 0;
-        }
-    } else {
-        // satisfied guards
-        successors = satisfied;
-        nbsucc = nbsat;
+    if (all_fail && step->unguarded) {
+        // else clause
+        next[nbsat].step = step->unguarded;
+        next[nbsat++].guard = NULL;
     }
+    return nbsat; // 0 if blocked
+}
+
+// Explore (i.e. add to the worklist with their updated environment)
+// all successors of a state
+// Returns the number of successors, `nbnew` of which had not been seen yet
+uint exec_step_all_proc (Worker* worker, uint pid, Compute* comp, uint* nbnew) {
+    *nbnew = 0;
+    RStep* step = get_step(comp->prog, comp->vec, pid);
+    if (!step) return 0; // NULL, blocked
+    Diff* diff = make_diff(&worker->arena, comp->diff);
+    diff->pid_advance = pid;
+    Var* var = step->assign ? step->assign->target : NULL;
+    diff->var_assign = var;
+    Succ* successors = worker->eval->succs;
+    uint nbsucc = next_steps(worker->eval, step, comp->vec, successors);
+    worker->nbtrans += nbsucc;
+    if (worker->profile) profile_step(worker->profile, worker->eval, step, comp->vec, nbsucc);
     // enqueue all successors
+    bool compact = worker->ex->opts->compact;
+    uint width = comp->prog->layout->nbword;
+    ull base [width];
+    ull base_hashed = comp->hashed;
+    if (compact) memcpy(base, comp->vec, width * sizeof(ull));
+    uint maxfused = compact ? comp->prog->procs[pid].nbstep : 0;
+    RStep* fused [maxfused + 1];
+    int vals [maxfused + 1];
     for (uint i = 0; i < nbsucc; i++) {
-        comp->state[pid] = successors[i];
+        uint nbfused = 0;
+        if (compact) {
+            memcpy(comp->vec, base, width * sizeof(ull));
+            comp->hashed = base_hashed;
+        }
+        // each successor overwrites the same fields
+        if (var) assign_var(comp, var->id, successors[i].val);
+        advance_step(comp, pid, successors[i].step);
+        if (compact) nbfused = run_fused(comp, pid, fused, vals);
         // record only if not already seen
-        if (try_insert(seen, comp)) {
-            comp->diff = dup_diff(diff);
-            comp->diff->new_step = comp->state[pid];
-            enqueue(todo, comp);
+        bool fresh = visit(worker, comp);
+        if (worker->profile) profile_next(worker->profile, step, successors + i, fresh);
+        if (fresh) {
+            comp->diff = dup_diff(&worker->arena, diff);
+            comp->diff->new_step = successors[i].step;
+            if (var) comp->diff->val_assign = successors[i].val;
+            comp->diff = fused_diffs(&worker->arena, comp->diff, pid, fused, vals, nbfused);
+            worker->nbfused += nbfused;
+            enqueue(worker->next, comp);
+            (*nbnew)++;
         }
     }
+    return nbsucc;
 }
 
-Sat* exec_prog_all (RProg* prog) {
-    Sat* sat = blank_sat(prog);
-    // setup computation state
-    Compute* comp = malloc(sizeof(Compute));
-    comp->sat = sat;
-    comp->prog = prog;
-    comp->env = blank_env(prog);
-    comp->state = init_state(prog);
-    comp->diff = make_diff(NULL);
-    // explored records
-    HashSet* seen = create_hashset(200);
-    WorkList* todo = create_worklist();
-    insert(seen, comp, hash(comp));
-    enqueue(todo, comp);
-    free_compute(comp);
-    while ((comp = dequeue(todo))) {
-        // loop as long as some configurations are unexplored
-        for (uint k = 0; k < prog->nbcheck; k++) {
-            int res = eval_expr(prog->checks[k].cond, comp->env);
-            if (res == 0 || res == INT_MIN) continue;
-            if (!comp->sat[k]) {
-                // found a solution
-                comp->sat[k] = comp->diff;
-            }
+// Record the checks that this state satisfies for the first time
+void update_sat (Worker* worker, Compute* comp) {
+    Explorer* ex = worker->ex;
+    for (uint k = 0; k < ex->prog->nbcheck; k++) {
+        if (__atomic_load_n(ex->sat + k, __ATOMIC_ACQUIRE)) continue;
+        if (!holds(worker->eval, ex->prog->checks[k].code, comp->vec)) continue;
+        // found a solution
+        // (all states of a level are as many transitions away from the start,
+        // but under --compact a transition may fuse several steps,
+        // so the trace is not always the shortest one)
+        pthread_mutex_lock(&ex->sat_lock);
+        if (!ex->sat[k]) {
+            __atomic_store_n(ex->sat + k, comp->diff, __ATOMIC_RELEASE);
+            record_witness(ex, k);
         }
-        // advance all processes in parallel
+        pthread_mutex_unlock(&ex->sat_lock);
+    }
+}
+
+// Partial order reduction:
+// a process whose current step is local can be advanced alone, since
+// none of the other processes can observe or influence this step.
+// To avoid ignoring the other processes forever along a cycle,
+// this is only done when all the resulting states are new
+// (i.e. discovered later than the current state).
+// Otherwise all processes are advanced.
+void expand_state (Worker* worker, Compute* comp) {
+    RProg* prog = worker->ex->prog;
+    bool done [prog->nbproc + 1];
+    memset(done, false, sizeof(done));
+    uint nbnew;
+    if (worker->ex->opts->por) {
         for (uint k = 0; k < prog->nbproc; k++) {
-            Compute* tmp = dup_compute(comp);
-            exec_step_all_proc(seen, todo, k, tmp);
-            free_compute(tmp);
+            RStep* step = get_step(prog, comp->vec, k);
+            if (!step || !step->local) continue;
+            copy_compute(worker->scratch, comp);
+            uint nbsucc = exec_step_all_proc(worker, k, worker->scratch, &nbnew);
+            done[k] = true;
+            if (nbsucc == 0) continue; // blocked, try another one
+            if (nbsucc == nbnew) return;
+            break;
         }
-        free_compute(comp);
     }
-    free_hashset(seen);
-    free(todo);
-    return sat;
+    // advance all processes in parallel
+    for (uint k = 0; k < prog->nbproc; k++) {
+        if (done[k]) continue;
+        copy_compute(worker->scratch, comp);
+        exec_step_all_proc(worker, k, worker->scratch, &nbnew);
+    }
+}
+
+void explore_level (Worker* worker) {
+    Explorer* ex = worker->ex;
+    Compute* comp = worker->current;
+    ull i;
+    while ((i = __atomic_fetch_add(&ex->claimed, 1, __ATOMIC_RELAXED)) < ex->level_size) {
+        Chunk* chunk = ex->level[i];
+        // once stopped, chunks are only given back
+        for (uint j = 0; j < chunk_len(chunk) && !stopped(ex); j++) {
+            chunk_get(chunk, j, comp);
+            update_sat(worker, comp);
+            expand_state(worker, comp);
+        }
+        // this worker may fill it again with the next level
+        recycle_chunk(worker->next, chunk);
+        if (worker == ex->workers) report_progress(ex);
+    }
+}
+
+void* worker_loop (void* arg) {
+    Worker* worker = arg;
+    for (;;) {
+        pthread_barrier_wait(&worker->ex->start);
+        if (worker->ex->done) return NULL;
+        explore_level(worker);
+        pthread_barrier_wait(&worker->ex->end);
+    }
+}
+
+// Gather the successors found by all workers into the next level
+void collect_level (Explorer* ex) {
+    ex->level_size = 0;
+    ex->frontier = 0;
+    for (uint w = 0; w < ex->nbworker; w++) {
+        Chunk* chunk;
+        while ((chunk = pop_chunk(ex->workers[w].next))) {
+            if (ex->level_size == ex->level_capacity) {
+                ex->level_capacity *= 2;
+                ex->level = realloc(ex->level, ex->level_capacity * sizeof(Chunk*));
+            }
+            ex->level[ex->level_size++] = chunk;
+            ex->frontier += chunk_len(chunk);
+        }
+    }
+    if (ex->frontier > ex->maxfrontier) ex->maxfrontier = ex->frontier;
+}
+
+// Whether the last checkpoint has been written (waits for it if `block`)
+bool checkpoint_done (Explorer* ex, bool block) {
+    if (ex->saver < 0) return true;
+    if (!waitpid(ex->saver, NULL, block ? 0 : WNOHANG)) return false;
+    ex->saver = -1;
+    return true;
+}
+
+// Write a checkpoint of the level about to be explored in the background,
+// unless the previous one is still being written
+void checkpoint (Explorer* ex) {
+    if (!checkpoint_done(ex, false)) return;
+    Snapshot snap;
+    snap.depth = ex->depth;
+    snap.nbstate = 0;
+    snap.nbrepr = 0;
+    snap.nbfused = 0;
+    snap.nbtrans = 0;
+    for (uint w = 0; w < ex->nbworker; w++) {
+        snap.nbstate += ex->workers[w].nbstate;
+        snap.nbrepr += ex->workers[w].nbrepr;
+        snap.nbfused += ex->workers[w].nbfused;
+        snap.nbtrans += ex->workers[w].nbtrans;
+    }
+    snap.maxfrontier = ex->maxfrontier;
+    snap.seconds = elapsed(&ex->clock);
+    snap.found_at = ex->found_at;
+    snap.sat = ex->sat;
+    ex->saver = save_checkpoint(ex->opts->checkpoint, ex->prog, ex->opts, &snap,
+        ex->seen, ex->bits, ex->level, ex->level_size);
+    if (ex->saver < 0) {
+        fprintf(stderr, "Cannot write checkpoint '%s': %s\n", ex->opts->checkpoint, strerror(errno));
+    }
+    ex->next_checkpoint = snap.seconds + (double)ex->opts->checkpoint_every;
+}
+
+// Start from the checkpoint instead of the initial state,
+// `*level` is set to the level it was taken before
+bool resume (Explorer* ex, uint* level) {
+    Snapshot snap;
+    snap.found_at = ex->found_at;
+    snap.sat = ex->sat;
+    if (!load_checkpoint(ex->opts->resume, ex->prog, ex->opts, &snap,
+        ex->seen, ex->bits, ex->workers[0].next)
+    ) {
+        return false;
+    }
+    ex->workers[0].nbstate = snap.nbstate;
+    ex->workers[0].nbrepr = snap.nbrepr;
+    ex->workers[0].nbfused = snap.nbfused;
+    ex->workers[0].nbtrans = snap.nbtrans;
+    ex->maxfrontier = snap.maxfrontier;
+    ex->depth = snap.depth;
+    *level = snap.depth;
+    // the clock goes on from the time of the checkpoint
+    long long nsec = (long long)ex->clock.tv_nsec - (long long)(snap.seconds * 1e9);
+    ex->clock.tv_sec += (time_t)(nsec / 1000000000);
+    ex->clock.tv_nsec = (long)(nsec % 1000000000);
+    if (ex->clock.tv_nsec < 0) {
+        ex->clock.tv_sec--;
+        ex->clock.tv_nsec += 1000000000;
+    }
+    ex->next_report = snap.seconds + ex->opts->progress;
+    ex->next_checkpoint = snap.seconds + (double)ex->opts->checkpoint_every;
+    for (uint k = 0; k < ex->prog->nbcheck; k++) {
+        if (!ex->sat[k] || (ex->opts->targets && !ex->opts->targets[k])) continue;
+        if (--ex->remaining == 0 && !ex->opts->full) ex->stop = true;
+    }
+    return true;
+}
+
+// Depth-first search keeps the path from the initial state on an explicit
+// stack. Each frame is a state, the process whose successors are being
+// visited and the next of them to visit: transitions are replayed from
+// the frame instead of allocating a diff for each one, and the diffs of
+// a trace are only built from the stack when a check is satisfied.
+// The successors listed by the frames are stacked in the same order
+// (only the top frame lists new ones).
+// Only the main thread explores, and neither --por nor --compact apply.
+//
+// Iterative deepening repeats it with a depth bound of 0, 1, 2, ... and
+// records the smallest depth of each state instead of whether it was seen,
+// so that checks are first satisfied with a shortest trace, as with BFS.
+
+// `nbnext` of a frame whose successors have not been listed yet
+#define UNLISTED UINT_MAX
+
+// Iterations of the depth-first and best-first searches between
+// two looks at the clock for --progress
+const ull PROGRESS_EVERY = 4096;
+
+typedef struct {
+    uint pid; // process whose successors are listed
+    uint first; // position of the first of them in `succs`
+    uint nbnext;
+    uint idx; // next successor to visit
+    Var* var; // assigned by all of them
+    // transition from the previous frame
+    uint in_pid;
+    RStep* in_step;
+    Var* in_var;
+    int in_val;
+} Frame;
+
+typedef struct {
+    Worker* worker;
+    uint width; // words of a state
+    uint size;
+    uint capacity;
+    Frame* frames;
+    ull* vecs; // `width` words per frame
+    ull* hashes; // incremental hash of each state
+    Succ* succs; // successors listed by the frames
+    uint succ_capacity;
+    // iterative deepening only
+    HashSet* depths; // smallest depth of each state, then the bound it was expanded with
+    uint bound; // UINT_MAX for DFS
+    ull nbnew; // states reached for the first time with the current bound
+    uint maxdepth;
+} Stack;
+
+void push_frame (Stack* st, Compute* comp, uint pid, RStep* step, Var* var, int val) {
+    if (st->size == st->capacity) {
+        st->capacity *= 2;
+        st->frames = realloc(st->frames, st->capacity * sizeof(Frame));
+        st->vecs = realloc(st->vecs, st->capacity * st->width * sizeof(ull));
+        st->hashes = realloc(st->hashes, st->capacity * sizeof(ull));
+    }
+    Frame* f = st->frames + st->size;
+    f->pid = 0;
+    f->first = st->size ? st->frames[st->size - 1].first + st->frames[st->size - 1].nbnext : 0;
+    f->nbnext = UNLISTED;
+    f->in_pid = pid;
+    f->in_step = step;
+    f->in_var = var;
+    f->in_val = val;
+    memcpy(st->vecs + st->size * st->width, comp->vec, st->width * sizeof(ull));
+    st->hashes[st->size] = comp->hashed;
+    st->size++;
+}
+
+// Load the state of frame `i` into `comp`
+void load_frame (Stack* st, uint i, Compute* comp) {
+    memcpy(comp->vec, st->vecs + i * st->width, st->width * sizeof(ull));
+    comp->hashed = st->hashes[i];
+}
+
+// Diffs from the initial state to the top of the stack
+Diff* stack_trace (Stack* st) {
+    Diff* diff = make_sat_diff(NULL);
+    for (uint i = 1; i < st->size; i++) {
+        Frame* f = st->frames + i;
+        diff = make_sat_diff(diff);
+        diff->pid_advance = f->in_pid;
+        diff->new_step = f->in_step;
+        diff->var_assign = f->in_var;
+        diff->val_assign = f->in_val;
+    }
+    return diff;
+}
+
+// Record the checks that the top of the stack satisfies for the first time
+void update_sat_stack (Stack* st, Compute* comp) {
+    Explorer* ex = st->worker->ex;
+    for (uint k = 0; k < ex->prog->nbcheck; k++) {
+        if (ex->sat[k]) continue;
+        if (!holds(st->worker->eval, ex->prog->checks[k].code, comp->vec)) continue;
+        ex->sat[k] = stack_trace(st);
+        record_witness(ex, k);
+    }
+}
+
+// Whether a state reached at `depth` must be explored (again) with the
+// current bound, `*fresh` is set if it had never been reached before
+bool improve_depth (Stack* st, Compute* comp, uint depth, bool* fresh) {
+    Explorer* ex = st->worker->ex;
+    ull key [st->width];
+    memcpy(key, comp->vec, st->width * sizeof(ull));
+    ull hashed = comp->hashed;
+    double orbit = 1;
+    if (ex->opts->symmetry) {
+        orbit = canonicalize(ex->prog, key);
+        hashed = hash_fields(ex->prog, key);
+    }
+    uint cwidth = ex->collapse ? collapse_width(ex->collapse) : st->width;
+    ull ckey [cwidth];
+    if (ex->collapse) {
+        collapse(ex->collapse, key, ckey);
+        hashed = hash_key(ckey, cwidth);
+    } else {
+        memcpy(ckey, key, cwidth * sizeof(ull));
+    }
+    ull* val = get_or_insert(st->depths, ckey, hashed ? hashed : 1, fresh);
+    if (*fresh) {
+        st->worker->nbstate++;
+        st->worker->nbrepr += orbit;
+        st->nbnew++;
+    } else if (depth > val[0] || (depth == val[0] && val[1] == st->bound)) {
+        return false;
+    }
+    val[0] = depth;
+    val[1] = st->bound;
+    return true;
+}
+
+// Visit everything reachable from the bottom of the stack
+// within the bound
+void search_stack (Stack* st) {
+    Worker* worker = st->worker;
+    RProg* prog = worker->ex->prog;
+    Compute* comp = worker->scratch;
+    // looking at the clock for every frame would be too costly
+    ull iter = 0;
+    while (st->size && !stopped(worker->ex)) {
+        if (++iter % PROGRESS_EVERY == 0) {
+            worker->ex->depth = st->size - 1;
+            worker->ex->frontier = st->size;
+            report_progress(worker->ex);
+        }
+        uint top = st->size - 1;
+        Frame* f = st->frames + top;
+        if (f->nbnext == UNLISTED) {
+            if (f->pid == prog->nbproc || top == st->bound) {
+                st->size--;
+                continue;
+            }
+            load_frame(st, top, comp);
+            RStep* step = get_step(prog, comp->vec, f->pid);
+            f->nbnext = 0;
+            f->idx = 0;
+            f->var = NULL;
+            if (step) {
+                while (f->first + max_next(step) > st->succ_capacity) {
+                    st->succ_capacity *= 2;
+                    st->succs = realloc(st->succs, st->succ_capacity * sizeof(Succ));
+                }
+                f->nbnext = next_steps(worker->eval, step, comp->vec, st->succs + f->first);
+                worker->nbtrans += f->nbnext;
+                if (worker->profile) profile_step(worker->profile, worker->eval, step, comp->vec, f->nbnext);
+                if (step->assign) f->var = step->assign->target;
+            }
+        }
+        if (f->idx == f->nbnext) {
+            f->pid++;
+            f->nbnext = UNLISTED;
+            continue;
+        }
+        // replay the transition from the frame
+        uint pid = f->pid;
+        Succ* succ = st->succs + f->first + f->idx++;
+        RStep* step = succ->step;
+        Var* var = f->var;
+        int val = succ->val;
+        load_frame(st, top, comp);
+        RStep* from = worker->profile ? get_step(prog, comp->vec, pid) : NULL;
+        if (var) assign_var(comp, var->id, val);
+        advance_step(comp, pid, step);
+        bool fresh;
+        bool expand;
+        if (st->depths) {
+            expand = improve_depth(st, comp, top + 1, &fresh);
+        } else {
+            expand = fresh = visit(worker, comp);
+        }
+        if (from) profile_next(worker->profile, from, succ, fresh);
+        if (!expand) continue;
+        push_frame(st, comp, pid, step, var, val);
+        if (top + 1 > st->maxdepth) st->maxdepth = top + 1;
+        if (fresh) update_sat_stack(st, comp);
+    }
+}
+
+void search_depth_first (Explorer* ex, Compute* root, ExecStats* stats) {
+    RProg* prog = ex->prog;
+    Stack st;
+    st.worker = ex->workers;
+    st.width = key_width(prog);
+    st.size = 0;
+    st.capacity = 64;
+    st.frames = malloc(st.capacity * sizeof(Frame));
+    st.vecs = malloc(st.capacity * st.width * sizeof(ull));
+    st.hashes = malloc(st.capacity * sizeof(ull));
+    st.succ_capacity = 64;
+    st.succs = malloc(st.succ_capacity * sizeof(Succ));
+    st.maxdepth = 0;
+    stats->nbbound = 0;
+    if (ex->opts->search == SEARCH_IDDFS) {
+        st.depths = create_hashmap(ex->collapse ? collapse_width(ex->collapse) : st.width, 2);
+        // stop at the first bound that reaches no new state
+        for (st.bound = 0; ; st.bound++) {
+            st.nbnew = 0;
+            bool fresh;
+            improve_depth(&st, root, 0, &fresh);
+            push_frame(&st, root, 0, NULL, NULL, 0);
+            if (fresh) update_sat_stack(&st, root);
+            search_stack(&st);
+            stats->nbbound++;
+            if (!st.nbnew || stopped(ex)) break;
+        }
+        hashset_stats(st.depths, &ex->visited);
+        free_hashset(st.depths);
+    } else {
+        st.depths = NULL;
+        st.bound = UINT_MAX;
+        visit(st.worker, root);
+        push_frame(&st, root, 0, NULL, NULL, 0);
+        update_sat_stack(&st, root);
+        search_stack(&st);
+    }
+    stats->maxdepth = st.maxdepth;
+    free(st.frames);
+    free(st.vecs);
+    free(st.hashes);
+    free(st.succs);
+}
+
+// Estimate first, then depth
+ull best_priority (Heuristic* heur, Compute* comp, Sat* sat) {
+    uint depth = comp->diff->depth < (1 << 24) ? comp->diff->depth : (1 << 24) - 1;
+    return (estimate(heur, comp->vec, sat) << 24) | depth;
+}
+
+typedef struct {
+    Heuristic* heur;
+    Sat* sat;
+} Priority;
+
+ull reorder_priority (void* ctx, Compute* comp) {
+    Priority* prio = ctx;
+    return best_priority(prio->heur, comp, prio->sat);
+}
+
+uint count_sat (Explorer* ex) {
+    uint nb = 0;
+    for (uint k = 0; k < ex->prog->nbcheck; k++) nb += ex->sat[k] != NULL;
+    return nb;
+}
+
+// Best-first search: states are expanded by increasing estimate of how
+// far they are from satisfying a check (see heuristic.h), the closest to
+// the initial state first among equal estimates. States are recorded when
+// they are generated, so traces may be longer than with BFS.
+// Once a check is satisfied, the states waiting to be expanded are
+// estimated again from the checks that remain.
+void search_best_first (Explorer* ex, Compute* root) {
+    Worker* worker = ex->workers;
+    Heuristic* heur = create_heuristic(ex->prog);
+    Frontier* frontier = create_frontier(key_width(ex->prog));
+    Priority prio = { heur, ex->sat };
+    uint nbsat = 0;
+    visit(worker, root);
+    push_frontier(frontier, root, best_priority(heur, root, ex->sat));
+    ull iter = 0;
+    while (!stopped(ex) && pop_frontier(frontier, worker->current)) {
+        if (worker->current->diff->depth - 1 > ex->depth) ex->depth = worker->current->diff->depth - 1;
+        update_sat(worker, worker->current);
+        if (count_sat(ex) > nbsat) {
+            nbsat = count_sat(ex);
+            reorder_frontier(frontier, reorder_priority, &prio, worker->scratch);
+        }
+        expand_state(worker, worker->current);
+        // successors are added to the worklist, move them to the frontier
+        Compute* next = worker->scratch;
+        while (dequeue(worker->next, next)) {
+            push_frontier(frontier, next, best_priority(heur, next, ex->sat));
+        }
+        ex->frontier = frontier_size(frontier);
+        if (ex->frontier > ex->maxfrontier) ex->maxfrontier = ex->frontier;
+        if (++iter % PROGRESS_EVERY == 0) report_progress(ex);
+    }
+    free_frontier(frontier);
+    free_heuristic(heur);
+}
+
+Sat* exec_prog_all (RProg* prog, ExecOpts* opts, ExecStats* stats) {
+    range_max = opts->range_max ? opts->range_max : 1;
+    range_truncated = false;
+    if (opts->external_dir) {
+        Sat* sat = exec_prog_external(prog, opts, stats);
+        stats->truncated = range_truncated;
+        return sat;
+    }
+    struct timespec began;
+    clock_gettime(CLOCK_MONOTONIC, &began);
+    Explorer ex;
+    ex.prog = prog;
+    ex.opts = opts;
+    ex.sat = blank_sat(prog);
+    bool bfs = opts->search == SEARCH_BFS;
+    bool depth_first = opts->search == SEARCH_DFS || opts->search == SEARCH_IDDFS;
+    ex.nbworker = (bfs && opts->threads) ? opts->threads : 1;
+    ex.seen = NULL;
+    ex.bits = NULL;
+    ex.collapse = NULL;
+    if (opts->bitstate && opts->search != SEARCH_IDDFS) {
+        ex.bits = create_bitstate(opts->bitstate);
+    } else {
+        if (opts->collapse) ex.collapse = create_collapse(prog, ex.nbworker);
+        // iterative deepening has a set of its own
+        if (opts->search != SEARCH_IDDFS) {
+            uint width = ex.collapse ? collapse_width(ex.collapse) : key_width(prog);
+            ex.seen = create_sharedset(width, ex.nbworker);
+        }
+    }
+    ex.level_capacity = 16;
+    ex.level = malloc(ex.level_capacity * sizeof(Chunk*));
+    ex.done = false;
+    pthread_mutex_init(&ex.sat_lock, NULL);
+    // initial state
+    Compute* comp = make_compute(prog, ex.sat);
+    ex.workers = malloc(ex.nbworker * sizeof(Worker));
+    for (uint w = 0; w < ex.nbworker; w++) {
+        ex.workers[w].ex = &ex;
+        ex.workers[w].next = create_worklist(key_width(prog));
+        ex.workers[w].current = make_compute(prog, ex.sat);
+        ex.workers[w].scratch = make_compute(prog, ex.sat);
+        ex.workers[w].arena = NULL;
+        ex.workers[w].nbstate = 0;
+        ex.workers[w].nbrepr = 0;
+        ex.workers[w].nbfused = 0;
+        ex.workers[w].nbtrans = 0;
+        ex.workers[w].profile = opts->profile ? create_profile(prog) : NULL;
+        ex.workers[w].eval = create_evalbuf(prog);
+    }
+    if (ex.nbworker > 1) {
+        pthread_barrier_init(&ex.start, NULL, ex.nbworker);
+        pthread_barrier_init(&ex.end, NULL, ex.nbworker);
+        // the main thread acts as worker 0
+        for (uint w = 1; w < ex.nbworker; w++) {
+            pthread_create(&ex.workers[w].thread, NULL, worker_loop, ex.workers + w);
+        }
+    }
+    if (!depth_first && opts->compact) {
+        for (uint pid = 0; pid < prog->nbproc; pid++) {
+            RStep* fused [prog->procs[pid].nbstep];
+            int vals [prog->procs[pid].nbstep];
+            uint nbfused = run_fused(comp, pid, fused, vals);
+            comp->diff = fused_diffs(&sat_arena, comp->diff, pid, fused, vals, nbfused);
+            ex.workers[0].nbfused += nbfused;
+        }
+    }
+    stats->nbbound = 0;
+    stats->maxdepth = 0;
+    ex.clock = began;
+    ex.found_at = alloc_sat(prog->nbcheck * sizeof(double));
+    ex.remaining = 0;
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        ex.found_at[k] = -1;
+        if (!opts->targets || opts->targets[k]) ex.remaining++;
+    }
+    ex.stop = false;
+    ex.depth = 0;
+    ex.frontier = 1;
+    ex.maxfrontier = 1;
+    ex.next_report = opts->progress;
+    memset(&ex.visited, 0, sizeof(SetStats));
+    ex.saver = -1;
+    ex.next_checkpoint = (double)opts->checkpoint_every;
+    bool failed = false;
+    uint first_level = 0;
+    if (opts->search == SEARCH_BEST) {
+        search_best_first(&ex, comp);
+    } else if (depth_first) {
+        search_depth_first(&ex, comp, stats);
+    } else if (opts->resume) {
+        failed = !resume(&ex, &first_level);
+    } else {
+        visit(ex.workers, comp);
+        enqueue(ex.workers[0].next, comp);
+    }
+    free_compute(comp);
+    // loop as long as some configurations are unexplored
+    for (uint level = first_level; bfs && !failed && !stopped(&ex); level++) {
+        collect_level(&ex);
+        if (!ex.level_size) break;
+        ex.depth = level;
+        if (opts->checkpoint && elapsed(&ex.clock) >= ex.next_checkpoint) checkpoint(&ex);
+        ex.claimed = 0;
+        if (ex.nbworker > 1) pthread_barrier_wait(&ex.start);
+        explore_level(ex.workers);
+        if (ex.nbworker > 1) pthread_barrier_wait(&ex.end);
+    }
+    checkpoint_done(&ex, true);
+    if (ex.nbworker > 1) {
+        ex.done = true;
+        pthread_barrier_wait(&ex.start);
+        for (uint w = 1; w < ex.nbworker; w++) {
+            pthread_join(ex.workers[w].thread, NULL);
+        }
+        pthread_barrier_destroy(&ex.start);
+        pthread_barrier_destroy(&ex.end);
+    }
+    stats->seconds = elapsed(&ex.clock);
+    stats->found_at = ex.found_at;
+    stats->stopped = ex.stop;
+    stats->truncated = range_truncated;
+    stats->nbstate = 0;
+    stats->nbrepr = 0;
+    stats->nbfused = 0;
+    stats->omission = ex.bits ? bitstate_omission(ex.bits) : 0;
+    stats->nbcomp = 0;
+    stats->compression = 1;
+    stats->nbtrans = 0;
+    stats->profile = ex.workers[0].profile;
+    if (!depth_first) stats->maxdepth = ex.depth;
+    // the stack holds one frame per level
+    stats->maxfrontier = depth_first ? stats->maxdepth : ex.maxfrontier;
+    for (uint w = 0; w < ex.nbworker; w++) {
+        stats->nbstate += ex.workers[w].nbstate;
+        stats->nbrepr += ex.workers[w].nbrepr;
+        stats->nbfused += ex.workers[w].nbfused;
+        stats->nbtrans += ex.workers[w].nbtrans;
+        if (w > 0 && ex.workers[w].profile) {
+            merge_profile(ex.workers[0].profile, ex.workers[w].profile);
+            free_profile(ex.workers[w].profile);
+        }
+        arena_merge(&sat_arena, &ex.workers[w].arena);
+        free_worklist(ex.workers[w].next);
+        free_compute(ex.workers[w].current);
+        free_compute(ex.workers[w].scratch);
+        free_evalbuf(ex.workers[w].eval);
+    }
+    pthread_mutex_destroy(&ex.sat_lock);
+    free(ex.workers);
+    free(ex.level);
+    if (ex.seen) sharedset_stats(ex.seen, &ex.visited);
+    if (ex.bits) bitstate_stats(ex.bits, &ex.visited);
+    if (ex.seen) free_sharedset(ex.seen);
+    if (ex.bits) free_bitstate(ex.bits);
+    if (ex.collapse) {
+        // keys, then components in their tables
+        double plain = (double)stats->nbstate * key_width(prog);
+        double packed = (double)stats->nbstate * collapse_width(ex.collapse)
+            + (double)collapse_words(ex.collapse);
+        stats->nbcomp = collapse_components(ex.collapse);
+        stats->compression = packed ? plain / packed : 1;
+        ex.visited.bytes += collapse_words(ex.collapse) * sizeof(ull);
+        free_collapse(ex.collapse);
+    }
+    SetStats* set = &ex.visited;
+    stats->load = set->capacity ? (double)set->nbkey / (double)set->capacity : 0;
+    stats->probes = set->lookups ? (double)set->probes / (double)set->lookups : 0;
+    stats->collisions = set->lookups ? (double)set->collisions / (double)set->lookups : 0;
+    stats->bytes = stats->nbstate ? (double)set->bytes / (double)stats->nbstate : 0;
+    stats->peak_kb = peak_memory();
+    return failed ? NULL : ex.sat;
 }
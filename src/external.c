@@ -0,0 +1,464 @@
+#include "external.h"
+#include "bytecode.h"
+#include "prelude.h"
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+// Files in the directory:
+//   layer-D.bin    states at depth D, sorted, with how they were reached
+//   visited-V.bin  states already visited, sorted, each in one of them
+//   run-R.bin      sorted successors of the current layer
+//   pass-R.bin     runs or visited files being merged
+//
+// A record of a layer is the packed state followed by these words:
+enum {
+    PARENT, // index of the parent in the previous layer
+    STEP, // process that advanced (high bits), index of its new step (low bits)
+    ASSIGN, // 1 + id of the variable assigned (high bits, 0 if none), value (low bits)
+    NB_EXTRA,
+};
+
+typedef struct {
+    RProg* prog;
+    char* dir;
+    uint width; // words in a state
+    uint stride; // words in a record of a layer
+    ull run_len; // records sorted in memory at once
+    bool failed;
+    ull nbtrans; // successors generated, visited or not
+    uint nbvisited; // visited files
+    struct timespec clock; // when the exploration started
+    double* found_at; // seconds until each check was satisfied
+} External;
+
+void file_path (External* ext, char* buf, size_t size, const char* kind, uint idx) {
+    snprintf(buf, size, "%s/%s-%u.bin", ext->dir, kind, idx);
+}
+
+FILE* open_file (External* ext, const char* kind, uint idx, const char* mode) {
+    char path [4096];
+    file_path(ext, path, sizeof(path), kind, idx);
+    FILE* f = fopen(path, mode);
+    if (!f && !ext->failed) {
+        fprintf(stderr, "Cannot open '%s': %s\n", path, strerror(errno));
+        ext->failed = true;
+    }
+    return f;
+}
+
+void remove_file (External* ext, const char* kind, uint idx) {
+    char path [4096];
+    file_path(ext, path, sizeof(path), kind, idx);
+    remove(path);
+}
+
+void rename_file (External* ext, const char* kind, uint idx, const char* to, uint to_idx) {
+    char src [4096];
+    char dst [4096];
+    file_path(ext, src, sizeof(src), kind, idx);
+    file_path(ext, dst, sizeof(dst), to, to_idx);
+    if (rename(src, dst) && !ext->failed) {
+        fprintf(stderr, "Cannot rename '%s': %s\n", src, strerror(errno));
+        ext->failed = true;
+    }
+}
+
+bool read_words (FILE* f, ull* buf, uint nb) {
+    return fread(buf, sizeof(ull), nb, f) == nb;
+}
+
+void write_words (External* ext, FILE* f, ull* buf, uint nb) {
+    if (fwrite(buf, sizeof(ull), nb, f) != nb && !ext->failed) {
+        fprintf(stderr, "Cannot write to '%s': %s\n", ext->dir, strerror(errno));
+        ext->failed = true;
+    }
+}
+
+void close_file (External* ext, FILE* f) {
+    if (f && fclose(f) && !ext->failed) {
+        fprintf(stderr, "Cannot write to '%s': %s\n", ext->dir, strerror(errno));
+        ext->failed = true;
+    }
+}
+
+// Lexicographic order on the first `nb` words
+int cmp_words (ull* lhs, ull* rhs, uint nb) {
+    for (uint i = 0; i < nb; i++) {
+        if (lhs[i] != rhs[i]) return lhs[i] < rhs[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// Records are sorted by state, then by parent and step,
+// so that the same trace is found every time
+uint sort_stride; // qsort does not take a context
+int cmp_record (const void* lhs, const void* rhs) {
+    return cmp_words((ull*)lhs, (ull*)rhs, sort_stride);
+}
+
+// Sort the records in memory and write them without duplicates
+void write_run (External* ext, ull* buf, ull nb, uint run) {
+    sort_stride = ext->stride;
+    qsort(buf, nb, ext->stride * sizeof(ull), cmp_record);
+    FILE* f = open_file(ext, "run", run, "wb");
+    if (!f) return;
+    for (ull i = 0; i < nb; i++) {
+        ull* rec = buf + i * ext->stride;
+        if (i > 0 && cmp_words(rec - ext->stride, rec, ext->width) == 0) continue;
+        write_words(ext, f, rec, ext->stride);
+    }
+    close_file(ext, f);
+}
+
+// Check and expand every state of the layer,
+// the successors are written to sorted runs
+// Returns the number of runs
+uint expand_layer (External* ext, uint depth, ull* buf, uint* hit_layer, ull* hit_idx) {
+    RProg* prog = ext->prog;
+    uint width = ext->width;
+    FILE* in = open_file(ext, "layer", depth, "rb");
+    if (!in) return 0;
+    Compute* comp = make_compute(prog, NULL);
+    EvalBuf* eval = create_evalbuf(prog);
+    ull rec [ext->stride];
+    ull nb = 0;
+    uint nbrun = 0;
+    for (ull idx = 0; !ext->failed && read_words(in, rec, ext->stride); idx++) {
+        for (uint k = 0; k < prog->nbcheck; k++) {
+            if (hit_layer[k] != UINT_MAX) continue;
+            if (!holds(eval, prog->checks[k].code, rec)) continue;
+            hit_layer[k] = depth;
+            hit_idx[k] = idx;
+            ext->found_at[k] = elapsed(&ext->clock);
+        }
+        for (uint pid = 0; pid < prog->nbproc; pid++) {
+            RStep* step = get_step(prog, rec, pid);
+            if (!step) continue;
+            Var* var = step->assign ? step->assign->target : NULL;
+            Succ* next = eval->succs;
+            uint nbnext = next_steps(eval, step, rec, next);
+            ext->nbtrans += nbnext;
+            memcpy(comp->vec, rec, width * sizeof(ull));
+            for (uint i = 0; i < nbnext; i++) {
+                if (var) set_var(prog, comp->vec, var->id, next[i].val);
+                set_step(prog, comp->vec, pid, next[i].step);
+                ull* out = buf + nb * ext->stride;
+                memcpy(out, comp->vec, width * sizeof(ull));
+                out[width + PARENT] = idx;
+                out[width + STEP] = ((ull)pid << 32) | (next[i].step ? next[i].step->idx : 0);
+                out[width + ASSIGN] = var
+                    ? ((ull)(var->id + 1) << 32) | (uint)next[i].val
+                    : 0;
+                if (++nb == ext->run_len) {
+                    write_run(ext, buf, nb, nbrun++);
+                    nb = 0;
+                }
+            }
+        }
+    }
+    if (nb) write_run(ext, buf, nb, nbrun++);
+    free_evalbuf(eval);
+    free_compute(comp);
+    fclose(in);
+    return nbrun;
+}
+
+// Runs, and visited files, are merged at most this many at once
+// so that the number of open files stays bounded
+const uint FAN_IN = 64;
+
+// Sorted files read together
+typedef struct {
+    uint nb;
+    uint stride; // words in a record
+    FILE** files;
+    ull* heads; // next record of each file
+    bool* live; // whether there is one
+} Merge;
+
+void open_merge (External* ext, Merge* m, const char* kind, uint first, uint nb, uint stride) {
+    m->nb = nb;
+    m->stride = stride;
+    m->files = malloc((nb + 1) * sizeof(FILE*));
+    m->heads = malloc((nb + 1) * stride * sizeof(ull));
+    m->live = malloc((nb + 1) * sizeof(bool));
+    for (uint i = 0; i < nb; i++) {
+        m->files[i] = open_file(ext, kind, first + i, "rb");
+        m->live[i] = m->files[i] && read_words(m->files[i], m->heads + i * stride, stride);
+    }
+}
+
+void close_merge (Merge* m) {
+    for (uint i = 0; i < m->nb; i++) {
+        if (m->files[i]) fclose(m->files[i]);
+    }
+    free(m->files);
+    free(m->heads);
+    free(m->live);
+}
+
+// Take the smallest record of all files, false once they are all read
+bool merge_next (Merge* m, ull* rec) {
+    int best = -1;
+    for (uint i = 0; i < m->nb; i++) {
+        if (!m->live[i]) continue;
+        if (best < 0 || cmp_words(m->heads + i * m->stride, m->heads + (uint)best * m->stride, m->stride) < 0) {
+            best = (int)i;
+        }
+    }
+    if (best < 0) return false;
+    ull* head = m->heads + (uint)best * m->stride;
+    memcpy(rec, head, m->stride * sizeof(ull));
+    m->live[best] = read_words(m->files[best], head, m->stride);
+    return true;
+}
+
+// Whether some file holds `key` (its first `width` words),
+// to be asked about increasing keys
+bool merge_has (Merge* m, ull* key, uint width) {
+    bool found = false;
+    for (uint i = 0; i < m->nb; i++) {
+        ull* head = m->heads + i * m->stride;
+        while (m->live[i] && cmp_words(head, key, width) < 0) {
+            m->live[i] = read_words(m->files[i], head, m->stride);
+        }
+        if (m->live[i] && cmp_words(head, key, width) == 0) found = true;
+    }
+    return found;
+}
+
+// Merge the files `kind`-`first` to `kind`-(`first`+`nb`-1) into pass-`out`,
+// records with the same state as the previous one are dropped
+void merge_files (External* ext, const char* kind, uint first, uint nb, uint stride, uint out) {
+    Merge m;
+    open_merge(ext, &m, kind, first, nb, stride);
+    FILE* f = open_file(ext, "pass", out, "wb");
+    ull rec [stride];
+    ull last [ext->width];
+    bool has_last = false;
+    while (!ext->failed && merge_next(&m, rec)) {
+        if (has_last && cmp_words(last, rec, ext->width) == 0) continue;
+        memcpy(last, rec, ext->width * sizeof(ull));
+        has_last = true;
+        write_words(ext, f, rec, stride);
+    }
+    close_file(ext, f);
+    close_merge(&m);
+    for (uint i = 0; i < nb; i++) remove_file(ext, kind, first + i);
+}
+
+// Merge the runs FAN_IN at a time until there are at most FAN_IN of them
+// Returns how many are left
+uint reduce_runs (External* ext, uint nbrun) {
+    while (nbrun > FAN_IN && !ext->failed) {
+        uint nbout = 0;
+        for (uint first = 0; first < nbrun; first += FAN_IN) {
+            uint nb = (nbrun - first < FAN_IN) ? nbrun - first : FAN_IN;
+            merge_files(ext, "run", first, nb, ext->stride, nbout++);
+        }
+        for (uint r = 0; r < nbout; r++) rename_file(ext, "pass", r, "run", r);
+        nbrun = nbout;
+    }
+    return nbrun;
+}
+
+// Merge the runs, remove the states already visited
+// and write the remaining ones as the next layer,
+// which is also added as a new visited file
+// Returns the size of the next layer
+ull merge_runs (External* ext, uint depth, uint nbrun) {
+    uint width = ext->width;
+    uint stride = ext->stride;
+    nbrun = reduce_runs(ext, nbrun);
+    Merge runs;
+    Merge visited;
+    open_merge(ext, &runs, "run", 0, nbrun, stride);
+    open_merge(ext, &visited, "visited", 0, ext->nbvisited, width);
+    FILE* vout = open_file(ext, "visited", ext->nbvisited, "wb");
+    FILE* lout = open_file(ext, "layer", depth + 1, "wb");
+    ull count = 0;
+    ull rec [stride];
+    ull last [width];
+    bool has_last = false;
+    while (!ext->failed && merge_next(&runs, rec)) {
+        // the same state in several runs, keep the first parent
+        if (has_last && cmp_words(last, rec, width) == 0) continue;
+        memcpy(last, rec, width * sizeof(ull));
+        has_last = true;
+        if (merge_has(&visited, rec, width)) continue;
+        write_words(ext, vout, rec, width);
+        write_words(ext, lout, rec, stride);
+        count++;
+    }
+    close_merge(&runs);
+    close_merge(&visited);
+    for (uint r = 0; r < nbrun; r++) remove_file(ext, "run", r);
+    close_file(ext, vout);
+    close_file(ext, lout);
+    if (!count) {
+        remove_file(ext, "visited", ext->nbvisited);
+    } else if (++ext->nbvisited > FAN_IN) {
+        // the visited files are disjoint, nothing is dropped
+        merge_files(ext, "visited", 0, ext->nbvisited, width, 0);
+        rename_file(ext, "pass", 0, "visited", 0);
+        ext->nbvisited = 1;
+    }
+    return count;
+}
+
+Var* find_var (RProg* prog, uint id) {
+    for (uint i = 0; i < prog->nbglob; i++) {
+        if (prog->globs[i].id == id) return prog->globs + i;
+    }
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        for (uint i = 0; i < proc->nbloc; i++) {
+            if (proc->locs[i].id == id) return proc->locs + i;
+        }
+    }
+    UNREACHABLE("no variable has id %d", id);
+}
+
+// Follow the parents back to the initial state, then build the diffs
+Diff* rebuild_trace (External* ext, uint layer, ull idx) {
+    RProg* prog = ext->prog;
+    uint width = ext->width;
+    ull* recs = malloc((layer + 1) * ext->stride * sizeof(ull));
+    for (uint d = layer; !ext->failed; d--) {
+        ull* rec = recs + d * ext->stride;
+        FILE* f = open_file(ext, "layer", d, "rb");
+        if (!f) break;
+        if (fseek(f, (long)(idx * ext->stride * sizeof(ull)), SEEK_SET)
+            || !read_words(f, rec, ext->stride)
+        ) {
+            fprintf(stderr, "Cannot read layer %d in '%s'\n", d, ext->dir);
+            ext->failed = true;
+        }
+        fclose(f);
+        if (d == 0) break;
+        idx = rec[width + PARENT];
+    }
+    Diff* diff = make_sat_diff(NULL);
+    for (uint d = 1; d <= layer && !ext->failed; d++) {
+        ull* rec = recs + d * ext->stride;
+        uint pid = (uint)(rec[width + STEP] >> 32);
+        diff = make_sat_diff(diff);
+        diff->pid_advance = pid;
+        diff->new_step = prog->procs[pid].steps[(uint)rec[width + STEP]];
+        if (rec[width + ASSIGN]) {
+            diff->var_assign = find_var(prog, (uint)(rec[width + ASSIGN] >> 32) - 1);
+            diff->val_assign = (int)(uint)rec[width + ASSIGN];
+        }
+    }
+    free(recs);
+    return diff;
+}
+
+// Whether some check is targeted and all targeted checks are satisfied
+bool all_targets (RProg* prog, ExecOpts* opts, uint* hit_layer) {
+    bool any = false;
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        if (opts->targets && !opts->targets[k]) continue;
+        if (hit_layer[k] == UINT_MAX) return false;
+        any = true;
+    }
+    return any;
+}
+
+Sat* exec_prog_external (RProg* prog, ExecOpts* opts, ExecStats* stats) {
+    if (opts->por || opts->symmetry || opts->compact || opts->threads > 1
+        || opts->bitstate || opts->collapse || opts->search != SEARCH_BFS
+        || opts->profile
+    ) {
+        fprintf(stderr, "Warning: only --stats and --trace apply with --external-dir, other options of --all are ignored\n");
+    }
+    if (mkdir(opts->external_dir, 0777) && errno != EEXIST) {
+        fprintf(stderr, "Cannot create '%s': %s\n", opts->external_dir, strerror(errno));
+        return NULL;
+    }
+    External ext;
+    ext.prog = prog;
+    ext.dir = opts->external_dir;
+    ext.width = prog->layout->nbword;
+    ext.stride = ext.width + NB_EXTRA;
+    ext.run_len = opts->external_mem / (ext.stride * sizeof(ull));
+    if (ext.run_len == 0) ext.run_len = 1;
+    ext.failed = false;
+    ext.nbtrans = 0;
+    clock_gettime(CLOCK_MONOTONIC, &ext.clock);
+    ext.found_at = alloc_sat(prog->nbcheck * sizeof(double));
+    uint hit_layer [prog->nbcheck + 1];
+    ull hit_idx [prog->nbcheck + 1];
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        hit_layer[k] = UINT_MAX;
+        ext.found_at[k] = -1;
+    }
+    stats->stopped = false;
+    // initial state
+    ull rec [ext.stride];
+    init_vec(prog, rec);
+    rec[ext.width + PARENT] = 0;
+    rec[ext.width + STEP] = 0;
+    rec[ext.width + ASSIGN] = 0;
+    FILE* f = open_file(&ext, "layer", 0, "wb");
+    if (f) write_words(&ext, f, rec, ext.stride);
+    close_file(&ext, f);
+    f = open_file(&ext, "visited", 0, "wb");
+    if (f) write_words(&ext, f, rec, ext.width);
+    close_file(&ext, f);
+    ext.nbvisited = 1;
+    stats->nbstate = 1;
+    stats->maxfrontier = 1;
+    // one layer at a time
+    ull* buf = malloc(ext.run_len * ext.stride * sizeof(ull));
+    uint depth = 0;
+    ull size = 1;
+    double next_report = opts->progress;
+    while (!ext.failed) {
+        double now = elapsed(&ext.clock);
+        if (opts->progress && now >= next_report) {
+            next_report = now + opts->progress;
+            print_progress(now, stats->nbstate, ext.nbtrans, depth, size);
+        }
+        uint nbrun = expand_layer(&ext, depth, buf, hit_layer, hit_idx);
+        if (!opts->full && all_targets(prog, opts, hit_layer)) {
+            // the successors are not needed
+            for (uint r = 0; r < nbrun; r++) remove_file(&ext, "run", r);
+            stats->stopped = true;
+            break;
+        }
+        size = merge_runs(&ext, depth, nbrun);
+        if (!size) break;
+        depth++;
+        stats->nbstate += size;
+        if (size > stats->maxfrontier) stats->maxfrontier = size;
+    }
+    free(buf);
+    Sat* sat = blank_sat(prog);
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        if (hit_layer[k] == UINT_MAX) continue;
+        sat[k] = rebuild_trace(&ext, hit_layer[k], hit_idx[k]);
+    }
+    // the last layer written may be empty
+    for (uint d = 0; d <= depth + 1; d++) remove_file(&ext, "layer", d);
+    for (uint v = 0; v <= ext.nbvisited; v++) remove_file(&ext, "visited", v);
+    stats->nbrepr = (double)stats->nbstate;
+    stats->nbfused = 0;
+    stats->omission = 0;
+    stats->nbcomp = 0;
+    stats->compression = 1;
+    stats->nbbound = 0;
+    stats->maxdepth = depth;
+    stats->nbtrans = ext.nbtrans;
+    // the sets are on disk
+    stats->load = 0;
+    stats->probes = 0;
+    stats->collisions = 0;
+    stats->bytes = 0;
+    stats->peak_kb = peak_memory();
+    stats->profile = NULL;
+    stats->seconds = elapsed(&ext.clock);
+    stats->found_at = ext.found_at;
+    return ext.failed ? NULL : sat;
+}
@@ -0,0 +1,234 @@
+#include "heuristic.h"
+#include "bytecode.h"
+#include "prelude.h"
+#include <limits.h>
+
+// Saturating distances, so that sums never wrap around
+#define FAR ((ull)1 << 32)
+
+// A condition ready for cond_dist: `&&` and `||` combine the distances
+// of their operands, comparisons compare the values of their operands,
+// anything else only tells whether it holds
+typedef struct Cond {
+    RExprKind type;
+    struct Cond* sub [2]; // E_AND, E_OR
+    Code* lhs; // comparisons
+    Code* rhs;
+    Code* code; // anything else
+} Cond;
+
+struct Heuristic {
+    RProg* prog;
+    // for each check, the distance from each step (by id)
+    // to a step that assigns a variable of the condition
+    uint** steps;
+    Cond** conds; // of each check
+    EvalBuf* eval;
+    int* vals [2]; // values of the operands of a comparison
+    uint nbval;
+};
+
+Cond* make_cond (RExpr* expr, Heuristic* heur) {
+    Cond* cond = malloc(sizeof(Cond));
+    cond->type = expr->type;
+    cond->sub[0] = cond->sub[1] = NULL;
+    cond->lhs = cond->rhs = cond->code = NULL;
+    Layout* layout = heur->prog->layout;
+    switch (expr->type) {
+        case E_AND: case E_OR:
+            cond->sub[0] = make_cond(expr->val.binop->lhs, heur);
+            cond->sub[1] = make_cond(expr->val.binop->rhs, heur);
+            break;
+        case E_EQ: case E_LT: case E_GT: case E_LEQ: case E_GEQ:
+            cond->lhs = compile_expr(expr->val.binop->lhs, layout);
+            cond->rhs = compile_expr(expr->val.binop->rhs, layout);
+            fit_evalbuf(heur->eval, cond->lhs);
+            fit_evalbuf(heur->eval, cond->rhs);
+            if (code_values(cond->lhs, range_max) > heur->nbval) heur->nbval = code_values(cond->lhs, range_max);
+            if (code_values(cond->rhs, range_max) > heur->nbval) heur->nbval = code_values(cond->rhs, range_max);
+            break;
+        default:
+            cond->code = compile_expr(expr, layout);
+            fit_evalbuf(heur->eval, cond->code);
+            break;
+    }
+    return cond;
+}
+
+void free_cond (Cond* cond) {
+    if (!cond) return;
+    free_cond(cond->sub[0]);
+    free_cond(cond->sub[1]);
+    free(cond);
+}
+
+void find_vars (RExpr* expr, bool* used) {
+    switch (expr->type) {
+        case E_VAR: used[expr->val.var->id] = true; return;
+        case E_VAL: return;
+        case MATCH_ANY_BINOP():
+            find_vars(expr->val.binop->lhs, used);
+            find_vars(expr->val.binop->rhs, used);
+            return;
+        case MATCH_ANY_MONOP(): find_vars(expr->val.subexpr, used); return;
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+}
+
+uint step_dist (uint* dist, RStep* step) {
+    return step ? dist[step->id] : UINT_MAX;
+}
+
+// Shortest distances in the graph of steps, by relaxing every edge
+// until nothing changes (the graphs are small)
+void distances (RProg* prog, bool* used, uint* dist) {
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        for (uint s = 1; s < proc->nbstep; s++) {
+            RStep* step = proc->steps[s];
+            bool assigns = step->assign && used[step->assign->target->id];
+            dist[step->id] = assigns ? 0 : UINT_MAX;
+        }
+    }
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint p = 0; p < prog->nbproc; p++) {
+            RProc* proc = prog->procs + p;
+            for (uint s = 1; s < proc->nbstep; s++) {
+                RStep* step = proc->steps[s];
+                uint best = step_dist(dist, step->unguarded);
+                for (uint i = 0; i < step->nbguarded; i++) {
+                    uint d = step_dist(dist, step->guarded[i].next);
+                    if (d < best) best = d;
+                }
+                if (best != UINT_MAX && best + 1 < dist[step->id]) {
+                    dist[step->id] = best + 1;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+Heuristic* create_heuristic (RProg* prog) {
+    Heuristic* heur = malloc(sizeof(Heuristic));
+    heur->prog = prog;
+    heur->steps = malloc(prog->nbcheck * sizeof(uint*));
+    heur->conds = malloc(prog->nbcheck * sizeof(Cond*));
+    heur->eval = create_evalbuf(prog);
+    heur->nbval = 1;
+    bool used [prog->nbvar + 1];
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        memset(used, false, sizeof(used));
+        find_vars(prog->checks[k].cond, used);
+        heur->steps[k] = malloc((prog->nbstep + 1) * sizeof(uint));
+        distances(prog, used, heur->steps[k]);
+        heur->conds[k] = make_cond(prog->checks[k].cond, heur);
+    }
+    heur->vals[0] = malloc(heur->nbval * sizeof(int));
+    heur->vals[1] = malloc(heur->nbval * sizeof(int));
+    return heur;
+}
+
+void free_heuristic (Heuristic* heur) {
+    for (uint k = 0; k < heur->prog->nbcheck; k++) {
+        free(heur->steps[k]);
+        free_cond(heur->conds[k]);
+    }
+    free(heur->steps);
+    free(heur->conds);
+    free_evalbuf(heur->eval);
+    free(heur->vals[0]);
+    free(heur->vals[1]);
+    free(heur);
+}
+
+ull far_sum (ull lhs, ull rhs) {
+    return (lhs + rhs < FAR) ? lhs + rhs : FAR;
+}
+
+// Values of `code` other than failures, sorted, written to `out`
+uint valid_values (Heuristic* heur, Code* code, Vec vec, int* out) {
+    if (!code->nondet) {
+        out[0] = exec_code(code, vec);
+        return out[0] != INT_MIN;
+    }
+    uint nb = all_values(heur->eval, code, vec);
+    // failures are sorted first
+    uint skip = (heur->eval->vals[0] == INT_MIN);
+    memcpy(out, heur->eval->vals + skip, (nb - skip) * sizeof(int));
+    return nb - skip;
+}
+
+// Smallest |l - r| over two sorted lists
+ull closest (int* lhs, uint nbl, int* rhs, uint nbr) {
+    ull best = FAR;
+    uint i = 0;
+    uint j = 0;
+    while (i < nbl && j < nbr) {
+        long long diff = (long long)lhs[i] - rhs[j];
+        ull dist = (ull)(diff < 0 ? -diff : diff);
+        if (dist < best) best = dist;
+        if (diff < 0) i++;
+        else j++;
+    }
+    return best;
+}
+
+// Comparisons count how much an operand must change, for the choice of
+// the ranges that comes closest, any other condition is 0 if some choice
+// satisfies it and 1 otherwise
+ull cond_dist (Heuristic* heur, Cond* cond, Vec vec) {
+    switch (cond->type) {
+        case E_AND:
+            return far_sum(cond_dist(heur, cond->sub[0], vec),
+                cond_dist(heur, cond->sub[1], vec));
+        case E_OR: {
+            ull lhs = cond_dist(heur, cond->sub[0], vec);
+            ull rhs = cond_dist(heur, cond->sub[1], vec);
+            return lhs < rhs ? lhs : rhs;
+        }
+        case E_EQ: case E_LT: case E_GT: case E_LEQ: case E_GEQ: {
+            int* l = heur->vals[0];
+            int* r = heur->vals[1];
+            uint nbl = valid_values(heur, cond->lhs, vec, l);
+            uint nbr = valid_values(heur, cond->rhs, vec, r);
+            if (!nbl || !nbr) return FAR;
+            if (cond->type == E_EQ) return closest(l, nbl, r, nbr);
+            // the other comparisons are closest with extreme values
+            long long res;
+            switch (cond->type) {
+                case E_LT: res = (long long)l[0] - r[nbr - 1] + 1; break;
+                case E_GT: res = 1 - ((long long)l[nbl - 1] - r[0]); break;
+                case E_LEQ: res = (long long)l[0] - r[nbr - 1]; break;
+                default: res = (long long)r[0] - l[nbl - 1]; break;
+            }
+            return res > 0 ? (ull)res : 0;
+        }
+        default: return holds(heur->eval, cond->code, vec) ? 0 : 1;
+    }
+}
+
+ull estimate (Heuristic* heur, Vec vec, Sat* sat) {
+    RProg* prog = heur->prog;
+    ull best = FAR;
+    bool any = false;
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        if (sat[k]) continue;
+        any = true;
+        ull cond = cond_dist(heur, heur->conds[k], vec);
+        if (cond == 0) return 0;
+        uint steps = UINT_MAX;
+        for (uint p = 0; p < prog->nbproc; p++) {
+            RStep* step = get_step(prog, vec, p);
+            uint d = step_dist(heur->steps[k], step);
+            if (d < steps) steps = d;
+        }
+        // no process will ever change the condition
+        if (steps == UINT_MAX) continue;
+        ull res = far_sum(cond, steps);
+        if (res < best) best = res;
+    }
+    return any ? best : 0;
+}
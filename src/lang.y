@@ -182,13 +182,31 @@ checks : REACH expr checks { ($$ = make_check($2))->next = $3; }
 #include "printer.h"
 #include "exec.h"
 #include "repr.h"
-
-enum { OK, ARGPARSE_ERROR, SYNTAX_ERROR, SEMANTIC_ERROR };
+#include <limits.h>
+
+enum { OK, ARGPARSE_ERROR, SYNTAX_ERROR, SEMANTIC_ERROR, EXTERNAL_ERROR };
+
+// Successors of a step are listed on the stack, keep --range-max reasonable
+const uint RANGE_MAX_LIMIT = 1 << 16;
+
+// `--target` is a comma-separated list of checks, numbered from 1
+// Returns false if it is invalid
+bool parse_targets (char* list, uint nbcheck, bool* targets) {
+    memset(targets, false, nbcheck * sizeof(bool));
+    char* end;
+    for (char* c = list; *c; c = (*end == ',') ? end + 1 : end) {
+        ull k = strtoull(c, &end, 10);
+        if (end == c || (*end && *end != ',') || k == 0 || k > nbcheck) {
+            fprintf(stderr, "Warning: --target '%s' does not name checks from 1 to %u, ignored\n",
+                list, nbcheck);
+            return false;
+        }
+        targets[k-1] = true;
+    }
+    return true;
+}
 
 int main (int argc, char **argv) {
-    {
-        srand((unsigned)(unsigned long long)getpid());
-    };
     Args* args = parse_args(argc, argv);
     if (!args) exit(ARGPARSE_ERROR);
 	if (!(yyin = fopen(args->fname_src, "r"))) {
@@ -202,7 +220,7 @@ int main (int argc, char **argv) {
     unique_stmt_id = 0;
 	if (!yyparse()) {
         if (args->flags&SHOW_AST) pp_ast(stdout, !(args->flags&NO_COLOR), program);
-        RProg* repr = tr_prog(program);
+        RProg* repr = tr_prog(program, !(args->flags&NO_SIMPLIFY));
         free_ast();
         fclose(yyin);
         yylex_destroy();
@@ -218,20 +236,87 @@ int main (int argc, char **argv) {
         if (args->flags&SHOW_REPR) pp_repr(stdout, !(args->flags&NO_COLOR), repr);
         if (args->flags&SHOW_DOT) make_dot(args->fname_src, repr);
         if (args->flags&EXEC_RAND) {
-            Sat* sat = exec_prog_random(repr);
+            RandOpts opts;
+            opts.threads = (uint)get_param(args, THREADS, 1);
+            // a different run every time unless a seed is given
+            opts.seed = get_param(args, SEED, (ull)getpid());
+            opts.adaptive = args->flags&ADAPTIVE;
+            opts.swarm = args->flags&SWARM;
+            opts.time_budget = get_param(args, TIME_BUDGET, 0);
+            // with another stopping criterion walks are not limited by default
+            bool bounded = !opts.adaptive && !opts.time_budget;
+            opts.walks = (uint)get_param(args, WALKS, bounded ? 100 : UINT_MAX);
+            opts.depth = (uint)get_param(args, DEPTH, 100);
+            RandStats stats;
+            Sat* sat = exec_prog_random(repr, &opts, &stats);
+            if (args->flags&SHOW_STATS) pp_rand_stats(&opts, &stats, !(args->flags&NO_COLOR));
             pp_sat(repr, sat, !(args->flags&NO_COLOR), args->flags&SHOW_TRACE, false);
             free_sat();
             // `sat` does not exit this scope
         }
         if (args->flags&EXEC_ALL) {
-            if (use_range) {
-                fprintf(stderr, "The 'range operator' feature is not available with --all. Use --rand instead.\n");
-            } else {
-                Sat* sat = exec_prog_all(repr);
-                pp_sat(repr, sat, !(args->flags&NO_COLOR), args->flags&SHOW_TRACE, true);
+            ExecOpts opts;
+            opts.search = (Search)get_choice(args, SEARCH, SEARCH_BFS);
+            bool depth_first = opts.search == SEARCH_DFS || opts.search == SEARCH_IDDFS;
+            opts.threads = (opts.search == SEARCH_BFS) ? (uint)get_param(args, THREADS, 1) : 1;
+            opts.por = !depth_first && (args->flags&PARTIAL_ORDER);
+            opts.symmetry = args->flags&SYMMETRY;
+            opts.compact = !depth_first && (args->flags&COMPACT);
+            opts.external_dir = args->params[EXTERNAL_DIR];
+            opts.external_mem = get_param(args, EXTERNAL_MEM, 256) << 20;
+            // iterative deepening needs the depth of each state
+            opts.bitstate = (opts.search == SEARCH_IDDFS) ? 0 : get_param(args, BITSTATE, 0) << 23;
+            opts.collapse = (args->flags&COLLAPSE) && !opts.bitstate;
+            opts.full = args->flags&FULL;
+            opts.range_max = (uint)get_param(args, RANGE_MAX, 1024);
+            if (opts.range_max == 0 || opts.range_max > RANGE_MAX_LIMIT) {
+                fprintf(stderr, "Warning: --range-max must be from 1 to %u, using %u\n",
+                    RANGE_MAX_LIMIT, opts.range_max ? RANGE_MAX_LIMIT : 1);
+                opts.range_max = opts.range_max ? RANGE_MAX_LIMIT : 1;
+            }
+            opts.progress = (uint)get_param(args, PROGRESS, 0);
+            opts.profile = args->flags&PROFILE;
+            // only the breadth-first search in memory takes checkpoints,
+            // a resumed run goes on saving to the same file
+            bool checkpoints = opts.search == SEARCH_BFS && !opts.collapse && !opts.external_dir;
+            opts.resume = checkpoints ? args->params[RESUME] : NULL;
+            opts.checkpoint = args->params[CHECKPOINT] ? args->params[CHECKPOINT] : opts.resume;
+            if (!checkpoints) opts.checkpoint = NULL;
+            opts.checkpoint_every = get_param(args, CHECKPOINT_EVERY, 300);
+            bool targets [repr->nbcheck + 1];
+            opts.targets = NULL;
+            if (args->params[TARGET] && parse_targets(args->params[TARGET], repr->nbcheck, targets)) {
+                opts.targets = targets;
+            }
+            ExecStats stats;
+            Sat* sat = exec_prog_all(repr, &opts, &stats);
+            if (!sat) {
+                // external exploration or resuming failed, cleanup
                 free_sat();
-                // `sat` does not exit this scope
+                free_var();
+                free_repr();
+                free(args);
+                free_ident();
+                exit(EXTERNAL_ERROR);
+            }
+            if (args->flags&SHOW_STATS) {
+                pp_stats(&opts, &stats, !(args->flags&NO_COLOR));
+                pp_found(repr, sat, &stats, !(args->flags&NO_COLOR));
+            }
+            if (opts.symmetry) pp_symmetry(&stats, !(args->flags&NO_COLOR));
+            if (opts.bitstate) pp_bitstate(&stats, !(args->flags&NO_COLOR));
+            if (opts.collapse && !opts.external_dir) pp_collapse(&stats, !(args->flags&NO_COLOR));
+            if (stats.truncated) pp_truncated(&opts, !(args->flags&NO_COLOR));
+            if (stats.profile) {
+                pp_profile(repr, stats.profile, !(args->flags&NO_COLOR));
+                free_profile(stats.profile);
             }
+            // with bitstate hashing, an early stop or truncated ranges
+            // some states may have been missed
+            pp_sat(repr, sat, !(args->flags&NO_COLOR), args->flags&SHOW_TRACE,
+                !opts.bitstate && !stats.stopped && !stats.truncated);
+            free_sat();
+            // `sat` does not exit this scope
         }
         free_var();
         free_repr();
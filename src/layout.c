@@ -0,0 +1,228 @@
+#include "layout.h"
+#include "reduce.h"
+#include "prelude.h"
+#include <limits.h>
+
+const Interval FULL = { INT_MIN, INT_MAX };
+const Interval BOOL = { 0, 1 };
+
+// After this many updates a variable is assumed to be unbounded
+// (e.g. `x := x + 1` would otherwise never stabilize)
+const uint WIDEN_AFTER = 8;
+
+Interval clamp (long long lo, long long hi) {
+    if (lo < INT_MIN || hi > INT_MAX) return FULL;
+    Interval res = { lo, hi };
+    return res;
+}
+
+long long min4 (long long a, long long b, long long c, long long d) {
+    long long m = a;
+    if (b < m) m = b;
+    if (c < m) m = c;
+    if (d < m) m = d;
+    return m;
+}
+
+long long max4 (long long a, long long b, long long c, long long d) {
+    long long m = a;
+    if (b > m) m = b;
+    if (c > m) m = c;
+    if (d > m) m = d;
+    return m;
+}
+
+long long magnitude (Interval r) {
+    return (-r.lo > r.hi) ? -r.lo : r.hi;
+}
+
+// Abstract evaluation of an expression given bounds for all variables
+// Overapproximates the set of values `eval_expr` may produce
+Interval eval_bounds (RExpr* expr, Interval* vars) {
+    switch (expr->type) {
+        case E_VAR: return vars[expr->val.var->id];
+        case E_VAL: return clamp((int)expr->val.digit, (int)expr->val.digit);
+        case E_LT: case E_GT: case E_EQ: case E_GEQ: case E_LEQ:
+        case E_AND: case E_OR: case E_NOT:
+            return BOOL;
+        case E_NEG: {
+            Interval r = eval_bounds(expr->val.subexpr, vars);
+            return clamp(-r.hi, -r.lo);
+        }
+        case E_ADD: case E_SUB: case E_MUL: case E_DIV: case E_MOD: case E_RANGE: {
+            Interval l = eval_bounds(expr->val.binop->lhs, vars);
+            Interval r = eval_bounds(expr->val.binop->rhs, vars);
+            switch (expr->type) {
+                case E_ADD: return clamp(l.lo + r.lo, l.hi + r.hi);
+                case E_SUB: return clamp(l.lo - r.hi, l.hi - r.lo);
+                case E_MUL: return clamp(
+                    min4(l.lo * r.lo, l.lo * r.hi, l.hi * r.lo, l.hi * r.hi),
+                    max4(l.lo * r.lo, l.lo * r.hi, l.hi * r.lo, l.hi * r.hi));
+                case E_DIV: {
+                    // |x / y| <= |x|
+                    long long m = magnitude(l);
+                    return clamp(-m, m);
+                }
+                case E_MOD: {
+                    // |x % y| < |y|, |x % y| <= |x| and the sign is that of x
+                    long long m = magnitude(l);
+                    long long d = magnitude(r) - 1;
+                    if (d < m) m = d;
+                    if (m < 0) m = 0;
+                    return clamp(l.lo < 0 ? -m : 0, l.hi > 0 ? m : 0);
+                }
+                case E_RANGE: return clamp(l.lo, r.hi);
+                default: UNREACHABLE("%d is not an arithmetic operator", expr->type);
+            }
+        }
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+}
+
+// Depth-first numbering of the steps reachable from the entrypoint
+void number_steps (RStep* step, RStep** found, uint* nb, bool* seen) {
+    if (!step || seen[step->id]) return;
+    seen[step->id] = true;
+    step->idx = *nb;
+    found[(*nb)++] = step;
+    for (uint i = 0; i < step->nbguarded; i++) {
+        number_steps(step->guarded[i].next, found, nb, seen);
+    }
+    number_steps(step->unguarded, found, nb, seen);
+}
+
+void collect_steps (RProg* prog) {
+    bool seen [prog->nbstep + 1];
+    RStep* found [prog->nbstep + 1];
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        memset(seen, false, sizeof(seen));
+        found[0] = NULL; // <END>
+        proc->nbstep = 1;
+        number_steps(proc->entrypoint, found, &proc->nbstep, seen);
+        proc->steps = alloc_repr(proc->nbstep * sizeof(RStep*));
+        memcpy(proc->steps, found, proc->nbstep * sizeof(RStep*));
+    }
+}
+
+// Fixpoint iteration over all assignments of the program
+// Variables start at 0
+void infer_bounds (RProg* prog, Interval* vars) {
+    uint updates [prog->nbvar + 1];
+    for (uint i = 0; i < prog->nbvar; i++) {
+        vars[i].lo = 0;
+        vars[i].hi = 0;
+        updates[i] = 0;
+    }
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint p = 0; p < prog->nbproc; p++) {
+            RProc* proc = prog->procs + p;
+            for (uint s = 1; s < proc->nbstep; s++) {
+                RAssign* assign = proc->steps[s]->assign;
+                if (!assign) continue;
+                Interval* target = vars + assign->target->id;
+                Interval r = eval_bounds(assign->expr, vars);
+                if (r.lo >= target->lo && r.hi <= target->hi) continue;
+                changed = true;
+                if (++updates[assign->target->id] > WIDEN_AFTER) {
+                    *target = FULL;
+                } else {
+                    if (r.lo < target->lo) target->lo = r.lo;
+                    if (r.hi > target->hi) target->hi = r.hi;
+                }
+            }
+        }
+    }
+}
+
+// Interchangeable processes must have the same layout for their
+// locals so that they can be permuted (see reduce.h)
+void share_bounds (RProg* prog, Interval* vars) {
+    for (uint pass = 0; pass < 2; pass++) {
+        for (uint q = 0; q < prog->nbproc; q++) {
+            RProc* tmpl = prog->procs + prog->procs[q].template;
+            RProc* proc = prog->procs + q;
+            for (uint l = 0; l < proc->nbloc; l++) {
+                Interval* src = vars + proc->locs[l].id;
+                Interval* dst = vars + tmpl->locs[l].id;
+                if (pass == 1) {
+                    // second pass: copy back to all processes
+                    Interval* tmp = src; src = dst; dst = tmp;
+                }
+                if (src->lo < dst->lo) dst->lo = src->lo;
+                if (src->hi > dst->hi) dst->hi = src->hi;
+            }
+        }
+    }
+}
+
+uint bit_width (ull span) {
+    uint width = 0;
+    while (span) { width++; span >>= 1; }
+    return width;
+}
+
+// First-fit decreasing: widest fields are placed first,
+// each one in the first word that has enough room left
+void place_fields (Layout* layout, Field** fields, uint* widths, uint nb) {
+    uint order [nb + 1];
+    for (uint i = 0; i < nb; i++) {
+        uint j = i;
+        while (j > 0 && widths[order[j-1]] < widths[i]) {
+            order[j] = order[j-1];
+            j--;
+        }
+        order[j] = i;
+    }
+    uint used [nb + 1]; // at most one word per field
+    layout->nbword = 0;
+    layout->nbbit = 0;
+    for (uint k = 0; k < nb; k++) {
+        uint i = order[k];
+        if (!widths[i]) {
+            // constant, takes no room
+            fields[i]->word = 0;
+            fields[i]->shift = 0;
+            fields[i]->mask = 0;
+            continue;
+        }
+        uint w = 0;
+        while (w < layout->nbword && used[w] + widths[i] > 64) w++;
+        if (w == layout->nbword) used[layout->nbword++] = 0;
+        fields[i]->word = w;
+        fields[i]->shift = used[w];
+        fields[i]->mask = (widths[i] == 64) ? ~0ull : (1ull << widths[i]) - 1;
+        used[w] += widths[i];
+        layout->nbbit += widths[i];
+    }
+    if (!layout->nbword) layout->nbword = 1; // keep states non-empty
+}
+
+Layout* make_layout (RProg* prog) {
+    Layout* layout = alloc_repr(sizeof(Layout));
+    layout->vars = alloc_repr(prog->nbvar * sizeof(Field));
+    layout->procs = alloc_repr(prog->nbproc * sizeof(Field));
+    collect_steps(prog);
+    find_templates(prog);
+    layout->bounds = alloc_repr(prog->nbvar * sizeof(Interval));
+    Interval* bounds = layout->bounds;
+    infer_bounds(prog, bounds);
+    share_bounds(prog, bounds);
+    uint nb = prog->nbvar + prog->nbproc;
+    Field* fields [nb + 1];
+    uint widths [nb + 1];
+    for (uint i = 0; i < prog->nbvar; i++) {
+        layout->vars[i].base = bounds[i].lo;
+        fields[i] = layout->vars + i;
+        widths[i] = bit_width((ull)(bounds[i].hi - bounds[i].lo));
+    }
+    for (uint p = 0; p < prog->nbproc; p++) {
+        layout->procs[p].base = 0;
+        fields[prog->nbvar + p] = layout->procs + p;
+        widths[prog->nbvar + p] = bit_width(prog->procs[p].nbstep - 1);
+    }
+    place_fields(layout, fields, widths, nb);
+    return layout;
+}
@@ -0,0 +1,80 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "repr.h"
+#include "prelude.h"
+
+// A state of the computation is a single packed vector of 64-bit words.
+// Each variable and each process is assigned a field of fixed width
+// inside one word (fields never straddle two words).
+//
+// Variables store their offset from the smallest value they can take,
+// the bounds are inferred from the program: a variable that only
+// ever receives 0 or 1 takes a single bit, one that is never assigned
+// takes none at all.
+//
+// Processes store the local index of their current step
+// (RStep.idx, 0 stands for <END>).
+
+typedef ull* Vec;
+
+typedef struct {
+    uint word; // which word of the vector
+    uint shift; // position of the lowest bit
+    ull mask; // (1 << width) - 1
+    long long base; // value represented by 0
+} Field;
+
+// Bounds of the values a variable may hold
+typedef struct {
+    long long lo;
+    long long hi;
+} Interval;
+
+typedef struct Layout {
+    uint nbword;
+    uint nbbit; // sum of all field widths
+    Field* vars; // indexed by Var.id
+    Field* procs; // indexed by process number
+    Interval* bounds; // of each variable, indexed by Var.id
+} Layout;
+
+// Infer variable bounds, number the steps of each process,
+// then arrange the fields in words
+// Everything is registered for deallocation by `free_repr`
+Layout* make_layout (RProg* prog);
+
+// Abstract evaluation of an expression given bounds for all variables
+// Overapproximates the set of values `eval_expr` may produce
+Interval eval_bounds (RExpr* expr, Interval* vars);
+
+// Number of bits needed to write `span`
+uint bit_width (ull span);
+
+static inline ull get_field (Field* f, Vec vec) {
+    return (vec[f->word] >> f->shift) & f->mask;
+}
+
+static inline void set_field (Field* f, Vec vec, ull val) {
+    vec[f->word] = (vec[f->word] & ~(f->mask << f->shift)) | (val << f->shift);
+}
+
+static inline int get_var (RProg* prog, Vec vec, uint id) {
+    Field* f = prog->layout->vars + id;
+    return (int)((long long)get_field(f, vec) + f->base);
+}
+
+static inline void set_var (RProg* prog, Vec vec, uint id, int val) {
+    Field* f = prog->layout->vars + id;
+    set_field(f, vec, (ull)((long long)val - f->base));
+}
+
+static inline RStep* get_step (RProg* prog, Vec vec, uint pid) {
+    return prog->procs[pid].steps[get_field(prog->layout->procs + pid, vec)];
+}
+
+static inline void set_step (RProg* prog, Vec vec, uint pid, RStep* step) {
+    set_field(prog->layout->procs + pid, vec, step ? step->idx : 0);
+}
+
+#endif // LAYOUT_H
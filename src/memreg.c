@@ -1,46 +1,79 @@
 #include "memreg.h"
 #include "prelude.h"
 
-const uint MBLOCK_SIZE = 100;
-
-typedef struct MemBlock {
-    uint len; // capacity is fixed, len is how many are filled
-    void** block; // array of pointers to free
-    struct MemBlock* next; // when block is full add a new record
-} MemBlock;
-
-void register_alloc (MemBlock** registry, void* ptr) {
-    if (!(*registry) || ((*registry) && (*registry)->len == MBLOCK_SIZE)) {
-        // block is full, allocate a new one
-        MemBlock* newblock = malloc(sizeof(MemBlock));
-        newblock->next = *registry;
-        newblock->len = 0;
-        newblock->block = malloc(MBLOCK_SIZE * sizeof(void*));
-        *registry = newblock;
+// Usual size of a slab, larger requests get a slab of their own
+const size_t SLAB_SIZE = 1 << 16;
+const size_t ALIGN = 16;
+
+typedef struct Arena {
+    size_t used;
+    size_t capacity;
+    struct Arena* next; // older slabs
+    char* data; // follows the header
+} Arena;
+
+const size_t HEADER = (sizeof(Arena) + 15) & ~(size_t)15;
+
+Arena* new_slab (size_t capacity, Arena* next) {
+    Arena* slab = malloc(HEADER + capacity);
+    slab->used = 0;
+    slab->capacity = capacity;
+    slab->next = next;
+    slab->data = (char*)slab + HEADER;
+    return slab;
+}
+
+void* arena_alloc (Arena** arena, size_t size) {
+    size = (size + ALIGN - 1) & ~(ALIGN - 1);
+    Arena* slab = *arena;
+    if (!slab || slab->used + size > slab->capacity) {
+        if (size > SLAB_SIZE / 4) {
+            // dedicated slab, inserted behind the current one
+            // so that the room left in it is not wasted
+            Arena* big = new_slab(size, slab ? slab->next : NULL);
+            if (slab) slab->next = big; else *arena = big;
+            big->used = size;
+            return big->data;
+        }
+        slab = *arena = new_slab(SLAB_SIZE, slab);
     }
-    (*registry)->block[(*registry)->len++] = ptr;
+    void* ptr = slab->data + slab->used;
+    slab->used += size;
+    return ptr;
+}
+
+char* arena_strdup (Arena** arena, const char* str) {
+    size_t len = strlen(str) + 1;
+    char* cpy = arena_alloc(arena, len);
+    memcpy(cpy, str, len);
+    return cpy;
 }
 
-void register_free (MemBlock** registry) {
+void arena_free (Arena** arena) {
 #if MEMREG_SHOW_STATS
-    uint nbblocks = 0;
-    uint nbcells = 0;
+    uint nbslabs = 0;
+    size_t nbbytes = 0;
 #endif // MEMREG_SHOW_STATS
-    while (*registry) {
-        MemBlock* tmp = *registry;
-        *registry = tmp->next;
-        for (uint i = 0; i < tmp->len; i++) free(tmp->block[i]);
+    while (*arena) {
+        Arena* tmp = *arena;
+        *arena = tmp->next;
 #if MEMREG_SHOW_STATS
-        nbblocks++;
-        nbcells += tmp->len;
+        nbslabs++;
+        nbbytes += tmp->used;
 #endif // MEMREG_SHOW_STATS
-        free(tmp->block);
         free(tmp);
     }
 #if MEMREG_SHOW_STATS
-    printf("-> %d memory blocks deallocated from %p\n", nbblocks, (void*)registry);
-    printf("   total %d * %d + %d = %d cells\n",
-        nbcells / MBLOCK_SIZE, MBLOCK_SIZE, nbcells % MBLOCK_SIZE, nbcells);
+    printf("-> %d slabs deallocated from %p\n", nbslabs, (void*)arena);
+    printf("   total %zu bytes used\n", nbbytes);
 #endif // MEMREG_SHOW_STATS
 }
 
+void arena_merge (Arena** into, Arena** from) {
+    if (!*from) return;
+    Arena* last = *from;
+    while (last->next) last = last->next;
+    last->next = *into;
+    *into = *from;
+    *from = NULL;
+}
@@ -2,6 +2,7 @@
 #define PRELUDE_H
 
 typedef unsigned int uint;
+typedef unsigned long long ull;
 
 #include <stdbool.h>
 #include <stdio.h>
@@ -218,6 +218,16 @@ void pp_rprog (RProg* prog) {
     for (uint i = 0; i < prog->nbcheck; i++) {
         pp_rcheck(prog->checks+i);
     }
+    if (prog->nbfold || prog->nbprune) {
+        pp_indent(0);
+        fprintf(fout, "%ssimplified %s%d expression%s, removed %d branch%s%s\n",
+            PURPLE, BLACK, prog->nbfold, prog->nbfold == 1 ? "" : "s",
+            prog->nbprune, prog->nbprune == 1 ? "" : "es", RESET);
+    }
+    pp_indent(0);
+    fprintf(fout, "%sstate %s%d bits in %d word%s%s\n",
+        PURPLE, BLACK, prog->layout->nbbit, prog->layout->nbword,
+        prog->layout->nbword > 1 ? "s" : "", RESET);
     fprintf(fout, "%s========================================%s\n\n", BLUE, RESET);
     free(explored_steps);
 }
@@ -580,7 +590,7 @@ void dot_rguard (uint parent_id, uint idx, RGuard* guard) {
     fprintf(fout, "guard_%d_%d -> step_%d\n", parent_id, idx, guard->next->id);
 }
 
-void pp_diff (RProg* prog, Diff* curr, Env env, bool isroot);
+void pp_diff (RProg* prog, Diff* curr, Vec vec, bool isroot);
 
 // Print reachability trace (i.e. walk back the chain of diffs)
 void pp_sat (RProg* prog, Sat* sat, bool color, bool trace, bool exhaustive) {
@@ -595,9 +605,9 @@ void pp_sat (RProg* prog, Sat* sat, bool color, bool trace, bool exhaustive) {
         if (sat[i]) {
             printf(" is reachable\n");
             if (trace) {
-                Env env = blank_env(prog);
-                pp_diff(prog, sat[i], env, true);
-                free(env);
+                ull vec [prog->layout->nbword];
+                init_vec(prog, vec);
+                pp_diff(prog, sat[i], vec, true);
             }
         } else if (exhaustive) {
             printf(" is not reachable\n");
@@ -607,10 +617,86 @@ void pp_sat (RProg* prog, Sat* sat, bool color, bool trace, bool exhaustive) {
     }
 }
 
-void pp_env (RProg* prog, Env env) {
+void pp_stats (ExecOpts* opts, ExecStats* stats, bool color) {
+    use_color = color;
+    double secs = stats->seconds > 0 ? stats->seconds : 1e-9;
+    printf(" %sStats%s: %llu states explored in %.3fs (%.0f states/s), %llu transitions",
+        BLUE, RESET, stats->nbstate, stats->seconds, (double)stats->nbstate / secs, stats->nbtrans);
+    if (opts->compact) printf(", %llu local steps merged", stats->nbfused);
+    // --external-dir is always breadth-first
+    if (!opts->external_dir && (opts->search == SEARCH_DFS || opts->search == SEARCH_IDDFS)) {
+        printf(", stack depth %u", stats->maxdepth);
+        if (opts->search == SEARCH_IDDFS) printf(", %u depth bounds", stats->nbbound);
+    } else {
+        printf(", depth %u, largest frontier %llu", stats->maxdepth, stats->maxfrontier);
+    }
+    if (stats->stopped) printf(", stopped once the targets were satisfied");
+    printf("\n");
+    printf(" %sMemory%s: peak %.1fMB", BLUE, RESET, (double)stats->peak_kb / 1024);
+    if (stats->bytes > 0) printf(", %.1f bytes per visited state", stats->bytes);
+    if (stats->load > 0) printf(", visited set %.0f%% full", stats->load * 100);
+    // the bitstate table does not probe
+    if (stats->probes > 0) {
+        printf(", %.2f probes per lookup, %.1f%% collisions", stats->probes, stats->collisions * 100);
+    }
+    printf("\n");
+}
+
+// The depth is the length of the trace
+void pp_found (RProg* prog, Sat* sat, ExecStats* stats, bool color) {
+    use_color = color;
+    for (uint k = 0; k < prog->nbcheck; k++) {
+        if (!sat[k]) continue;
+        printf(" %sFound%s {%d} at depth %u after %.3fs\n",
+            BLUE, RESET, k+1, sat[k]->depth - 1, stats->found_at[k]);
+    }
+}
+
+void pp_rand_stats (RandOpts* opts, RandStats* stats, bool color) {
+    use_color = color;
+    double secs = stats->seconds > 0 ? stats->seconds : 1e-9;
+    printf(" %sStats%s: %llu walks, %llu steps in %.3fs (%.0f walks/s, %.0f steps/s)",
+        BLUE, RESET, stats->nbwalk, stats->nbstep, stats->seconds,
+        (double)stats->nbwalk / secs, (double)stats->nbstep / secs);
+    if (opts->adaptive) printf(", %llu distinct states", stats->nbstate);
+    printf("\n");
+}
+
+void pp_symmetry (ExecStats* stats, bool color) {
+    use_color = color;
+    printf(" %sSymmetry%s: %llu states stand for %.0f (reduction x%.2f)\n",
+        BLUE, RESET, stats->nbstate, stats->nbrepr,
+        stats->nbstate ? stats->nbrepr / (double)stats->nbstate : 1.0);
+}
+
+// The omission probability is that of the last states, the estimate
+// of missed states is thus pessimistic
+void pp_bitstate (ExecStats* stats, bool color) {
+    use_color = color;
+    double missed = (double)stats->nbstate * stats->omission;
+    printf(" %sBitstate%s: %llu states stored, omission probability %.2e,"
+        " about %.0f states missed (coverage %.2f%%)\n",
+        BLUE, RESET, stats->nbstate, stats->omission, missed,
+        100 * (double)stats->nbstate / ((double)stats->nbstate + missed));
+}
+
+void pp_collapse (ExecStats* stats, bool color) {
+    use_color = color;
+    printf(" %sCollapse%s: %llu process components interned (compression x%.2f)\n",
+        BLUE, RESET, stats->nbcomp, stats->compression);
+}
+
+void pp_truncated (ExecOpts* opts, bool color) {
+    use_color = color;
+    printf(" %sRange%s: only %u values of each range were explored,"
+        " some states may have been missed\n",
+        BLUE, RESET, opts->range_max);
+}
+
+void pp_env (RProg* prog, Vec vec) {
     printf("  %s| %s* global %s", BLUE, BLACK, GREEN);
     for (uint i = 0; i < prog->nbglob; i++) {
-        printf("[%s: %d] ", prog->globs[i].name, env[prog->globs[i].id]);
+        printf("[%s: %d] ", prog->globs[i].name, get_var(prog, vec, prog->globs[i].id));
     }
     printf("%s\n", RESET);
     for (uint p = 0; p < prog->nbproc; p++) {
@@ -619,21 +705,21 @@ void pp_env (RProg* prog, Env env) {
         printf("  %s| %s* local %s'%s'%s: %s",
             BLUE, BLACK, PURPLE, proc->name, BLACK, GREEN);
         for (uint i = 0; i < proc->nbloc; i++) {
-            printf("[%s: %d] ", proc->locs[i].name, env[proc->locs[i].id]);
+            printf("[%s: %d] ", proc->locs[i].name, get_var(prog, vec, proc->locs[i].id));
         }
         printf("%s\n", RESET);
     }
 }
 
-void pp_diff (RProg* prog, Diff* curr, Env env, bool isroot) {
+void pp_diff (RProg* prog, Diff* curr, Vec vec, bool isroot) {
     if (curr->parent) {
-        pp_diff(prog, curr->parent, env, false);
+        pp_diff(prog, curr->parent, vec, false);
         if (curr->var_assign) {
             printf("%s  | ", BLUE);
             printf("%s{%d. %s}", CYAN, curr->var_assign->id, curr->var_assign->name);
             printf("%s <- %s%d%s\n", RESET, YELLOW, curr->val_assign, RESET);
-            env[curr->var_assign->id] = curr->val_assign;
-            pp_env(prog, env);
+            set_var(prog, vec, curr->var_assign->id, curr->val_assign);
+            pp_env(prog, vec);
         } 
         if (!isroot) {
             printf("  %s| %s'%s'%s",
@@ -650,6 +736,45 @@ void pp_diff (RProg* prog, Diff* curr, Env env, bool isroot) {
                 BLUE, PURPLE, prog->procs[i].name, BLACK,
                 RED, prog->procs[i].entrypoint->id, RESET);    
         }
-        pp_env(prog, env);
+        pp_env(prog, vec);
+    }
+}
+
+void pp_counters (ull* counts, ull total) {
+    printf("%12llu %12llu %8llu %12llu %12llu",
+        counts[PROF_EVAL], counts[PROF_ENABLED], counts[PROF_DIVZERO],
+        counts[PROF_NEW], counts[PROF_SEEN]);
+    if (total) printf(" %6.1f%%", 100 * (double)counts[PROF_EVAL] / (double)total);
+    printf("\n");
+}
+
+// One line per step then one per guard, the last column is the share
+// of the step in all the evaluations of steps
+void pp_profile (RProg* prog, Profile* prof, bool color) {
+    use_color = color;
+    ull total = 0;
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        for (uint s = 1; s < proc->nbstep; s++) {
+            total += step_counters(prof, proc->steps[s])[PROF_EVAL];
+        }
+    }
+    printf(" %sProfile%s:%19s %12s %8s %12s %12s %7s\n", BLUE, RESET,
+        "evaluated", "enabled", "div/0", "new", "seen", "share");
+    char label [32];
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        printf("  %sthread '%s'%s\n", PURPLE, proc->name, RESET);
+        for (uint s = 1; s < proc->nbstep; s++) {
+            RStep* step = proc->steps[s];
+            snprintf(label, sizeof(label), "<%d>", step->id);
+            printf("    %s%-12s%s", YELLOW, label, RESET);
+            pp_counters(step_counters(prof, step), total);
+            for (uint i = 0; i < step->nbguarded; i++) {
+                snprintf(label, sizeof(label), "jump [%d]", step->guarded[i].next->id);
+                printf("      %s%-10s%s", RED, label, RESET);
+                pp_counters(guard_counters(prof, step, i), 0);
+            }
+        }
     }
 }
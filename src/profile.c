@@ -0,0 +1,92 @@
+#include "profile.h"
+#include "bytecode.h"
+#include "prelude.h"
+#include <limits.h>
+
+struct Profile {
+    RProg* prog;
+    uint nbslot;
+    uint* first_guard; // slot of the first guard of each step (by id)
+    ull* counts; // NB_PROF per slot: the steps by id, then the guards
+};
+
+Profile* create_profile (RProg* prog) {
+    Profile* prof = malloc(sizeof(Profile));
+    prof->prog = prog;
+    prof->first_guard = malloc((prog->nbstep + 1) * sizeof(uint));
+    prof->nbslot = prog->nbstep + 1;
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        for (uint s = 1; s < proc->nbstep; s++) {
+            RStep* step = proc->steps[s];
+            prof->first_guard[step->id] = prof->nbslot;
+            prof->nbslot += step->nbguarded;
+        }
+    }
+    prof->counts = calloc(prof->nbslot * NB_PROF, sizeof(ull));
+    return prof;
+}
+
+void free_profile (Profile* prof) {
+    free(prof->first_guard);
+    free(prof->counts);
+    free(prof);
+}
+
+void merge_profile (Profile* prof, Profile* other) {
+    for (uint i = 0; i < prof->nbslot * NB_PROF; i++) {
+        prof->counts[i] += other->counts[i];
+    }
+}
+
+ull* step_counters (Profile* prof, RStep* step) {
+    return prof->counts + step->id * NB_PROF;
+}
+
+ull* guard_counters (Profile* prof, RStep* step, uint i) {
+    return prof->counts + (prof->first_guard[step->id] + i) * NB_PROF;
+}
+
+// Whether some value of `code` is not 0, and whether some is a division by zero
+// (the exploration only tells whether a guard holds)
+void prof_eval (EvalBuf* buf, Code* code, Vec vec, bool* nonzero, bool* divzero) {
+    *nonzero = false;
+    *divzero = false;
+    if (!code->nondet) {
+        int res = exec_code(code, vec);
+        *nonzero = res && res != INT_MIN;
+        *divzero = res == INT_MIN;
+        return;
+    }
+    uint nb = all_values(buf, code, vec);
+    for (uint i = 0; i < nb; i++) {
+        if (buf->vals[i] == INT_MIN) *divzero = true;
+        else if (buf->vals[i]) *nonzero = true;
+    }
+}
+
+void profile_step (Profile* prof, EvalBuf* buf, RStep* step, Vec vec, uint nbnext) {
+    ull* counts = step_counters(prof, step);
+    counts[PROF_EVAL]++;
+    if (nbnext) counts[PROF_ENABLED]++;
+    bool nonzero, divzero;
+    if (step->assign) {
+        prof_eval(buf, step->assign->code, vec, &nonzero, &divzero);
+        if (divzero) counts[PROF_DIVZERO]++;
+    }
+    for (uint i = 0; i < step->nbguarded; i++) {
+        ull* guard = guard_counters(prof, step, i);
+        prof_eval(buf, step->guarded[i].code, vec, &nonzero, &divzero);
+        guard[PROF_EVAL]++;
+        if (nonzero) guard[PROF_ENABLED]++;
+        if (divzero) guard[PROF_DIVZERO]++;
+    }
+}
+
+void profile_next (Profile* prof, RStep* step, Succ* next, bool fresh) {
+    ProfCounter kind = fresh ? PROF_NEW : PROF_SEEN;
+    step_counters(prof, step)[kind]++;
+    if (next->guard) {
+        guard_counters(prof, step, (uint)(next->guard - step->guarded))[kind]++;
+    }
+}
@@ -0,0 +1,173 @@
+#include "reduce.h"
+#include "bytecode.h"
+#include "prelude.h"
+
+bool is_local_var (RProc* proc, Var* var) {
+    return var >= proc->locs && var < proc->locs + proc->nbloc;
+}
+
+bool is_local_expr (RProc* proc, RExpr* expr) {
+    switch (expr->type) {
+        case E_VAR: return is_local_var(proc, expr->val.var);
+        case E_VAL: return true;
+        case MATCH_ANY_BINOP():
+            return is_local_expr(proc, expr->val.binop->lhs)
+                && is_local_expr(proc, expr->val.binop->rhs);
+        case MATCH_ANY_MONOP():
+            return is_local_expr(proc, expr->val.subexpr);
+        default: UNREACHABLE("%d is not a valid expr discriminant", expr->type);
+    }
+}
+
+bool is_local_step (RProc* proc, RStep* step) {
+    if (step->assign) {
+        if (!is_local_var(proc, step->assign->target)) return false;
+        if (!is_local_expr(proc, step->assign->expr)) return false;
+    }
+    for (uint i = 0; i < step->nbguarded; i++) {
+        if (!is_local_expr(proc, step->guarded[i].cond)) return false;
+    }
+    return true;
+}
+
+void find_local_steps (RProg* prog) {
+    for (uint p = 0; p < prog->nbproc; p++) {
+        RProc* proc = prog->procs + p;
+        for (uint s = 1; s < proc->nbstep; s++) {
+            RStep* step = proc->steps[s];
+            step->local = is_local_step(proc, step);
+            // a range gives an assignment several successors
+            step->fusible = step->local && step->nbguarded == 0
+                && !(step->assign && has_range(step->assign->expr));
+        }
+    }
+}
+
+bool same_var (RProc* lproc, RProc* rproc, Var* lhs, Var* rhs) {
+    if (is_local_var(lproc, lhs)) {
+        return is_local_var(rproc, rhs) && lhs - lproc->locs == rhs - rproc->locs;
+    }
+    return lhs == rhs;
+}
+
+bool same_expr (RProc* lproc, RProc* rproc, RExpr* lhs, RExpr* rhs) {
+    if (lhs->type != rhs->type) return false;
+    switch (lhs->type) {
+        case E_VAR: return same_var(lproc, rproc, lhs->val.var, rhs->val.var);
+        case E_VAL: return lhs->val.digit == rhs->val.digit;
+        case MATCH_ANY_BINOP():
+            return same_expr(lproc, rproc, lhs->val.binop->lhs, rhs->val.binop->lhs)
+                && same_expr(lproc, rproc, lhs->val.binop->rhs, rhs->val.binop->rhs);
+        case MATCH_ANY_MONOP():
+            return same_expr(lproc, rproc, lhs->val.subexpr, rhs->val.subexpr);
+        default: UNREACHABLE("%d is not a valid expr discriminant", lhs->type);
+    }
+}
+
+// Steps are numbered by a depth-first traversal, so identical graphs
+// have identical numberings and can be compared index by index
+bool same_step (RProc* lproc, RProc* rproc, RStep* lhs, RStep* rhs) {
+    if (!lhs->assign != !rhs->assign) return false;
+    if (lhs->assign) {
+        if (!same_var(lproc, rproc, lhs->assign->target, rhs->assign->target)) return false;
+        if (!same_expr(lproc, rproc, lhs->assign->expr, rhs->assign->expr)) return false;
+    }
+    if (lhs->nbguarded != rhs->nbguarded) return false;
+    for (uint i = 0; i < lhs->nbguarded; i++) {
+        if (!same_expr(lproc, rproc, lhs->guarded[i].cond, rhs->guarded[i].cond)) return false;
+        if (lhs->guarded[i].next->idx != rhs->guarded[i].next->idx) return false;
+    }
+    if (!lhs->unguarded != !rhs->unguarded) return false;
+    return !lhs->unguarded || lhs->unguarded->idx == rhs->unguarded->idx;
+}
+
+bool same_proc (RProc* lhs, RProc* rhs) {
+    if (lhs->nbloc != rhs->nbloc || lhs->nbstep != rhs->nbstep) return false;
+    for (uint s = 1; s < lhs->nbstep; s++) {
+        if (!same_step(lhs, rhs, lhs->steps[s], rhs->steps[s])) return false;
+    }
+    return true;
+}
+
+void find_templates (RProg* prog) {
+    for (uint q = 0; q < prog->nbproc; q++) {
+        prog->procs[q].template = q;
+        for (uint p = 0; p < q; p++) {
+            if (prog->procs[p].template == p && same_proc(prog->procs + p, prog->procs + q)) {
+                prog->procs[q].template = p;
+                break;
+            }
+        }
+    }
+}
+
+Symmetry* make_symmetry (RProg* prog) {
+    Symmetry* sym = alloc_repr(sizeof(Symmetry));
+    uint count [prog->nbproc + 1];
+    memset(count, 0, sizeof(count));
+    for (uint p = 0; p < prog->nbproc; p++) count[prog->procs[p].template]++;
+    sym->nbclass = 0;
+    for (uint p = 0; p < prog->nbproc; p++) {
+        if (count[p] > 1) sym->nbclass++;
+    }
+    sym->sizes = alloc_repr(sym->nbclass * sizeof(uint));
+    sym->procs = alloc_repr(sym->nbclass * sizeof(uint*));
+    uint c = 0;
+    for (uint p = 0; p < prog->nbproc; p++) {
+        if (count[p] < 2) continue;
+        sym->sizes[c] = 0;
+        sym->procs[c] = alloc_repr(count[p] * sizeof(uint));
+        for (uint q = p; q < prog->nbproc; q++) {
+            if (prog->procs[q].template == p) sym->procs[c][sym->sizes[c]++] = q;
+        }
+        c++;
+    }
+    return sym;
+}
+
+int compare_tuples (ull* lhs, ull* rhs, uint width) {
+    for (uint i = 0; i < width; i++) {
+        if (lhs[i] != rhs[i]) return (lhs[i] < rhs[i]) ? -1 : 1;
+    }
+    return 0;
+}
+
+double canonicalize (RProg* prog, Vec vec) {
+    Symmetry* sym = prog->symmetry;
+    Layout* layout = prog->layout;
+    double orbit = 1;
+    for (uint c = 0; c < sym->nbclass; c++) {
+        uint n = sym->sizes[c];
+        uint* procs = sym->procs[c];
+        uint width = 1 + prog->procs[procs[0]].nbloc;
+        // read and sort the (step, locals) of each process in the group
+        ull tuples [n][width];
+        for (uint i = 0; i < n; i++) {
+            RProc* proc = prog->procs + procs[i];
+            ull tuple [width];
+            tuple[0] = get_field(layout->procs + procs[i], vec);
+            for (uint l = 0; l < proc->nbloc; l++) {
+                tuple[1+l] = get_field(layout->vars + proc->locs[l].id, vec);
+            }
+            uint j = i;
+            while (j > 0 && compare_tuples(tuples[j-1], tuple, width) > 0) {
+                memcpy(tuples[j], tuples[j-1], sizeof(tuple));
+                j--;
+            }
+            memcpy(tuples[j], tuple, sizeof(tuple));
+        }
+        // write them back in order
+        // and count the distinct permutations: n! / (product of multiplicities!)
+        uint run = 0;
+        for (uint i = 0; i < n; i++) {
+            RProc* proc = prog->procs + procs[i];
+            set_field(layout->procs + procs[i], vec, tuples[i][0]);
+            for (uint l = 0; l < proc->nbloc; l++) {
+                set_field(layout->vars + proc->locs[l].id, vec, tuples[i][1+l]);
+            }
+            run = (i > 0 && compare_tuples(tuples[i-1], tuples[i], width) == 0) ? run + 1 : 1;
+            orbit = orbit * (i + 1) / run;
+        }
+    }
+    return orbit;
+}
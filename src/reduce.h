@@ -0,0 +1,43 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include "repr.h"
+#include "layout.h"
+#include "prelude.h"
+
+// Static analyses that allow the exhaustive exploration
+// to skip some of the configurations
+
+// Mark as `local` every step whose assignment and guards only
+// read and write local variables of its own process.
+// Such a step commutes with any step of another process, and since
+// checks can only observe global variables it is invisible to them.
+// Local steps without guards or ranges are also marked `fusible`: they
+// have a single successor and can be executed as part of the transition
+// that leads to them without changing which checks are reachable.
+void find_local_steps (RProg* prog);
+
+// Processes whose step graphs are identical (up to the renaming of their
+// local variables) are interchangeable: permuting them maps reachable
+// configurations to reachable configurations and does not change the
+// value of any check.
+// Each process is given a `template`, the first process identical to it.
+// Requires steps to be numbered (see layout.h).
+void find_templates (RProg* prog);
+
+// Groups of at least two interchangeable processes
+typedef struct Symmetry {
+    uint nbclass;
+    uint* sizes; // number of processes in each group
+    uint** procs; // processes of each group
+} Symmetry;
+
+// Build the groups from the templates
+Symmetry* make_symmetry (RProg* prog);
+
+// Replace a state by the representative of all its permutations:
+// inside each group, the (step, locals) of the processes are sorted.
+// Returns the number of distinct states that have this representative.
+double canonicalize (RProg* prog, Vec vec);
+
+#endif // REDUCE_H
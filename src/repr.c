@@ -1,9 +1,13 @@
 #include "repr.h"
+#include "layout.h"
+#include "reduce.h"
+#include "bytecode.h"
+#include "simplify.h"
 #include "memreg.h"
 
-MemBlock* repr_alloc_registry = NULL;
-void register_repr (void* ptr) { register_alloc(&repr_alloc_registry, ptr); }
-void free_repr () { register_free(&repr_alloc_registry); }
+Arena* repr_arena = NULL;
+void* alloc_repr (size_t size) { return arena_alloc(&repr_arena, size); }
+void free_repr () { arena_free(&repr_arena); }
 
 uint tr_var_list (Var** loc, Var* in);
 uint tr_check_list (RCheck** loc, Check* in);
@@ -41,10 +45,9 @@ Var* globs;
 Var* locs;
 char* procname;
 
-RProg* tr_prog (Prog* in) {
+RProg* tr_prog (Prog* in, bool simplify) {
     failed = false;
-    RProg* out = malloc(sizeof(RProg));
-    register_repr(out);
+    RProg* out = alloc_repr(sizeof(RProg));
     out->nbstep = in->nbstmt;
     out->nbvar = in->nbvar;
     // Write global variables
@@ -56,6 +59,13 @@ RProg* tr_prog (Prog* in) {
     if (failed) {
         return NULL; // out is still registered for free
     } else {
+        out->nbfold = 0;
+        out->nbprune = 0;
+        if (simplify) simplify_prog(out);
+        out->layout = make_layout(out);
+        find_local_steps(out);
+        out->symmetry = make_symmetry(out);
+        compile_prog(out);
         return out;
     }
 }
@@ -66,8 +76,7 @@ uint tr_var_list (Var** loc, Var* in) {
         uint len = 0;
         Var* cur = in;
         while (cur) { len++; cur = cur->next; }
-        *loc = malloc(len * sizeof(Var));
-        register_repr(*loc);
+        *loc = alloc_repr(len * sizeof(Var));
     }
     uint n = 0;
     Var* cur = in;
@@ -85,8 +94,7 @@ uint tr_check_list (RCheck** loc, Check* in) {
         uint len = 0;
         Check* cur = in;
         while (cur) { len++; cur = cur->next; }
-        *loc = malloc(len * sizeof(Check));
-        register_repr(*loc);
+        *loc = alloc_repr(len * sizeof(Check));
     }
     // no local variables during checks
     nbloc = 0;
@@ -97,6 +105,7 @@ uint tr_check_list (RCheck** loc, Check* in) {
     Check* cur = in;
     while (cur) {
         (*loc)[n].cond = tr_expr(cur->cond);
+        (*loc)[n].code = NULL;
         n++;
         cur = cur->next;
     }
@@ -104,8 +113,7 @@ uint tr_check_list (RCheck** loc, Check* in) {
 }
 
 RExpr* tr_expr (Expr* in) {
-    RExpr* out = malloc(sizeof(RExpr));
-    register_repr(out);
+    RExpr* out = alloc_repr(sizeof(RExpr));
     out->type = in->type;
     switch (in->type) {
         case E_VAR:
@@ -115,8 +123,7 @@ RExpr* tr_expr (Expr* in) {
             out->val.digit = in->val.digit;
             break;
         case MATCH_ANY_BINOP():
-            out->val.binop = malloc(sizeof(RBinop));
-            register_repr(out->val.binop);
+            out->val.binop = alloc_repr(sizeof(RBinop));
             out->val.binop->lhs = tr_expr(in->val.binop->lhs);
             out->val.binop->rhs = tr_expr(in->val.binop->rhs);
             break;
@@ -150,8 +157,7 @@ uint tr_proc_list (RProc** loc, Proc* in) {
         uint len = 0;
         Proc* cur = in;
         while (cur) { len++; cur = cur->next; }
-        *loc = malloc(len * sizeof(RProc));
-        register_repr(*loc);
+        *loc = alloc_repr(len * sizeof(RProc));
     }
     uint n = 0;
     Proc* cur = in;
@@ -175,10 +181,10 @@ uint tr_proc_list (RProc** loc, Proc* in) {
 }
 
 RAssign* tr_assign (Assign* in) {
-    RAssign* out = malloc(sizeof(RAssign));
-    register_repr(out);
+    RAssign* out = alloc_repr(sizeof(RAssign));
     out->target = locate_var(in->target);
     out->expr = tr_expr(in->value);
+    out->code = NULL;
     return out;
 }
 
@@ -186,8 +192,7 @@ void tr_stmt (
     RStep** out, Stmt* in,
     bool advance, RStep* skipto, RStep* breakto
 ) {
-    *out = malloc(sizeof(RStep));
-    register_repr(*out);
+    *out = alloc_repr(sizeof(RStep));
     (*out)->assign = NULL;
     (*out)->id = in->id;
     switch (in->type) {
@@ -207,8 +212,7 @@ void tr_stmt (
                 (*out)->unguarded = skipto;
                 (*out)->advance = advance;
             } else if (in->next) {
-                (*out)->unguarded = malloc(sizeof(RStep));
-                register_repr((*out)->unguarded);
+                (*out)->unguarded = alloc_repr(sizeof(RStep));
                 tr_stmt(
                         &((*out)->unguarded), in->next,
                         advance, skipto, breakto); // normal transfer
@@ -225,8 +229,7 @@ void tr_stmt (
             (*out)->advance = true;
             int isdo = in->type == S_DO;
             if (in->next) {
-                RStep* next = malloc(sizeof(RStep));
-                register_repr(next);
+                RStep* next = alloc_repr(sizeof(RStep));
                 tr_stmt(
                     &next, in->next,
                     advance, skipto, breakto);
@@ -268,8 +271,7 @@ RStep* tr_branch_list (
         uint len = 0;
         Branch* cur = in;
         while (cur && cur->cond) { len++; cur = cur->next; }
-        *loc = malloc(len * sizeof(RGuard));
-        register_repr(*loc);
+        *loc = alloc_repr(len * sizeof(RGuard));
         *nb = len;
     }
     uint n = 0;
@@ -277,6 +279,7 @@ RStep* tr_branch_list (
     while (cur && cur->cond) {
         RGuard* out = *loc + n;
         out->cond = tr_expr(cur->cond);
+        out->code = NULL;
         tr_stmt(
             &out->next, cur->stmt,
             advance, skipto, breakto);
@@ -285,8 +288,7 @@ RStep* tr_branch_list (
     }
     // else clause
     if (cur) {
-        RStep* end = malloc(sizeof(RStep));
-        register_repr(end);
+        RStep* end = alloc_repr(sizeof(RStep));
         tr_stmt(
             &end, cur->stmt,
             advance, skipto, breakto);
@@ -4,6 +4,7 @@
 #include "ast.h"
 
 void free_repr (); // to be called at the very end
+void* alloc_repr (size_t size); // deallocated by free_repr
 
 // A different representation, more suited for execution
 // Not a tree but an execution graph
@@ -11,6 +12,7 @@ void free_repr (); // to be called at the very end
 struct RExpr;
 struct RStep;
 struct RGuard;
+struct Code;
 
 // a binary operation
 typedef struct {
@@ -34,6 +36,7 @@ typedef struct RExpr {
 typedef struct {
     Var* target;
     RExpr* expr;
+    struct Code* code; // compiled expr (see bytecode.h)
 } RAssign;
 
 // represents a choice (possibly only one solution)
@@ -44,11 +47,15 @@ typedef struct RStep {
     struct RGuard* guarded; // choose any if satisfied
     struct RStep* unguarded; // otherwise go here
     uint id;
+    uint idx; // index in the process' steps (see layout.h)
+    bool local; // only uses local variables (see reduce.h)
+    bool fusible; // local and without guards
 } RStep;
 
 // represents a guarded instruction
 typedef struct RGuard {
     RExpr* cond;
+    struct Code* code; // compiled cond
     RStep* next;
 } RGuard; 
 
@@ -67,11 +74,15 @@ typedef struct {
     uint nbloc;
     Var* locs;
     RStep* entrypoint;
+    uint nbstep; // including <END> at index 0
+    RStep** steps; // all steps reachable from entrypoint
+    uint template; // first process with the same code (see reduce.h)
 } RProc;
 
 // a reachability test
 typedef struct {
     RExpr* cond;
+    struct Code* code; // compiled cond
 } RCheck;
 
 // a full program
@@ -84,8 +95,13 @@ typedef struct {
     uint nbcheck;
     RCheck* checks;
     uint nbstep;
+    struct Layout* layout; // how states are packed
+    struct Symmetry* symmetry; // interchangeable processes
+    uint nbfold; // expressions rewritten (see simplify.h)
+    uint nbprune; // guards and else clauses removed
 } RProg;
 
-RProg* tr_prog (Prog* in);
+// `simplify` enables the rewriting of expressions
+RProg* tr_prog (Prog* in, bool simplify);
 
 #endif // REPR_H
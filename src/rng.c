@@ -0,0 +1,14 @@
+#include "rng.h"
+
+_Thread_local Rng thread_rng;
+
+// splitmix64 spreads the seed over the whole state
+// (xoshiro must not start from all zeros)
+void rng_seed (Rng* rng, ull seed) {
+    for (uint i = 0; i < 4; i++) {
+        ull z = (seed += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        rng->s[i] = z ^ (z >> 31);
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include "repr.h"
+#include "prelude.h"
+
+// Rewrite expressions in place before execution:
+// - constant subexpressions are evaluated
+//   (a constant division by zero becomes `1 / 0`),
+// - neutral operands are removed (`x + 0`, `x * 1`, ...),
+// - `&&` and `||` with a constant operand are reduced when the other
+//   side cannot fail (evaluation is not lazy: `0 && 1 / 0` blocks).
+// Guards that can never be satisfied are then removed; if a step
+// loses all its guards and has no else clause, a single `0` guard
+// is kept so that it stays blocked.
+// An else clause that can never be taken (some guard is always
+// satisfied) is removed as well.
+//
+// Values and blocking behavior are preserved exactly, only the number
+// of calls to `rand` made by range operators may differ.
+void simplify_prog (RProg* prog);
+
+#endif // SIMPLIFY_H
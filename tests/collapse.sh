@@ -0,0 +1,39 @@
+#!/bin/bash
+# Collapse compression (--collapse) interns the component of each process
+# in a table that grows as it fills: with enough components per process
+# to grow it several times, the results must be those of plain --all
+#
+#   tests/collapse.sh
+
+cd "$(dirname "$0")/.."
+BIN=./lang
+TMP=$(mktemp -d)
+trap 'rm -rf $TMP' EXIT
+status=0
+
+# each process goes through about 180 local components
+bench/gen.sh counters 2 60 > $TMP/counters.prog
+
+# the checks and the number of states
+run () {
+    $BIN $TMP/counters.prog "$@" --all --full --stats --no-color \
+        | grep -E 'reachable|states explored' | sed -E 's/ in [0-9.]+s \([0-9]+ states\/s\)//'
+}
+
+check () {
+    if [ "$2" = "$3" ]; then
+        echo "ok: $1"
+    else
+        echo "FAILED: $1"
+        status=1
+    fi
+}
+
+expected=$(run)
+check "collapse" "$(run --collapse)" "$expected"
+check "collapse with threads" "$(run --collapse --threads 2)" "$expected"
+check "collapse with dfs" "$(run --collapse --search dfs)" "$(run --search dfs)"
+comps=$($BIN $TMP/counters.prog --all --full --stats --collapse --no-color | sed -nE 's/ Collapse: ([0-9]+) .*/\1/p')
+check "more than 128 components per process" "$([ "${comps:-0}" -gt 256 ] && echo yes)" yes
+
+exit $status
@@ -0,0 +1,60 @@
+#!/bin/bash
+# Every engine of the exhaustive exploration reaches the same checks as
+# plain --all on the families of bench/gen.sh and on ranges, and those
+# that do not reduce the state space explore the same number of states
+# (the reduction of --symmetry is undone by the count it reports)
+#
+#   tests/engines.sh
+
+cd "$(dirname "$0")/.."
+BIN=./lang
+TMP=$(mktemp -d)
+trap 'rm -rf $TMP' EXIT
+status=0
+
+bench/gen.sh counters 3 4 > $TMP/counters.prog
+bench/gen.sh filter 3 > $TMP/filter.prog
+bench/gen.sh philosophers 3 > $TMP/philosophers.prog
+bench/gen.sh buffer 2 2 > $TMP/buffer.prog
+bench/gen.sh grid 3 3 > $TMP/grid.prog
+cp assets/range.prog $TMP/range.prog
+
+# the checks that were reached, then the number of states
+summary () {
+    $BIN "$@" --all --full --stats --no-color | awk '
+        / is reachable/ { print $1 }
+        /states explored/ { nb = $2 }
+        /states stand for/ { nb = $6 }
+        END { print nb " states" }'
+}
+
+# the checks only
+reached () {
+    summary "$@" | grep -v states
+}
+
+check () {
+    if [ "$2" = "$3" ]; then
+        echo "ok: $1"
+    else
+        echo "FAILED: $1"
+        status=1
+    fi
+}
+
+for model in counters filter philosophers buffer grid range; do
+    prog=$TMP/$model.prog
+    expected=$(summary $prog)
+    for engine in "--symmetry" "--collapse" "--bitstate 16" "--external-dir $TMP/ext" \
+            "--threads 2" "--search dfs" "--search iddfs" "--search best"; do
+        rm -rf $TMP/ext
+        mkdir $TMP/ext
+        check "$model with $engine" "$(summary $prog $engine)" "$expected"
+    done
+    expected=$(reached $prog)
+    for engine in "--por" "--compact"; do
+        check "$model with $engine" "$(reached $prog $engine)" "$expected"
+    done
+done
+
+exit $status
@@ -0,0 +1,70 @@
+#!/bin/bash
+# Ranges in guards: the exhaustive exploration reaches the same checks
+# as the random execution, in particular the else branch next to guards
+# that hold for some of their values only
+#
+#   tests/range.sh
+
+cd "$(dirname "$0")/.."
+BIN=./lang
+TMP=$(mktemp -d)
+trap 'rm -rf $TMP' EXIT
+status=0
+
+# the checks that were reached
+reached () {
+    $BIN "$@" --no-color | grep ' is reachable' | cut -d' ' -f2
+}
+
+check () {
+    if [ "$2" = "$3" ]; then
+        echo "ok: $1"
+    else
+        echo "FAILED: $1"
+        status=1
+    fi
+}
+
+cat > $TMP/guards.prog <<'PROG'
+var a, b, c;
+proc p
+    if
+    :: {0..1} -> a := 1
+    :: 2 * {0..1} == 2 -> a := 2
+    :: else -> a := 3
+    fi
+end
+
+proc q
+    if
+    :: {1..2} -> b := 1
+    :: else -> b := 2
+    fi
+end
+
+proc r
+    if
+    :: {0..1} -> c := 1
+    :: 1 -> c := 2
+    :: else -> c := 3
+    fi
+end
+
+reach a == 1 // reachable
+reach a == 2 // reachable
+reach a == 3 // reachable
+reach b == 1 // reachable
+reach b == 2 // unreachable
+reach c == 1 // reachable
+reach c == 2 // reachable
+reach c == 3 // unreachable
+PROG
+
+for model in assets/range.prog $TMP/guards.prog; do
+    name=$(basename $model)
+    check "$name with --all and --rand" \
+        "$(reached $model --all)" "$(reached $model --rand --seed 1 --walks 1000)"
+done
+check "else next to ranges" "$(reached $TMP/guards.prog --all | tr '\n' ' ')" "{1} {2} {3} {4} {6} {7} "
+
+exit $status
@@ -0,0 +1,47 @@
+#!/bin/bash
+# Resuming the exhaustive exploration from a checkpoint (--resume):
+# it reaches the same results as a run from the start, and it is refused
+# once the program has changed, even when its layout has not
+#
+#   tests/resume.sh
+
+cd "$(dirname "$0")/.."
+BIN=./lang
+MODEL=assets/peterson.prog
+TMP=$(mktemp -d)
+trap 'rm -rf $TMP' EXIT
+status=0
+
+# everything but the timings and the memory
+run () {
+    $BIN "$@" --all --full --trace --stats --no-color \
+        | grep -v Memory | sed -E 's/ in [0-9.]+s \([0-9]+ states\/s\)//; s/ after [0-9.]+s//'
+}
+
+check () {
+    if [ "$2" = "$3" ]; then
+        echo "ok: $1"
+    else
+        echo "FAILED: $1"
+        status=1
+    fi
+}
+
+expected=$(run $MODEL)
+run $MODEL --checkpoint $TMP/ckpt --checkpoint-every 0 > /dev/null
+cp $TMP/ckpt $TMP/saved
+check "checkpoint written" "$(test -s $TMP/saved && echo yes)" yes
+
+cp $TMP/saved $TMP/ckpt
+check "resume the same program" "$(run $MODEL --resume $TMP/ckpt 2>&1)" "$expected"
+
+# the same variables with the same bounds, only the code differs
+sed 's/v := 0/v := 1/' $MODEL > $TMP/step.prog
+sed 's/c == 3/c == 0/' $MODEL > $TMP/check.prog
+for edited in step check; do
+    cp $TMP/saved $TMP/ckpt
+    $BIN $TMP/$edited.prog --all --resume $TMP/ckpt > /dev/null 2>&1
+    check "refuse an edited $edited" $? 4
+done
+
+exit $status